@@ -1,6 +1,16 @@
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include<algorithm>
+#include <numeric>
+#include <cstdint>
+#include <string>
+
+#include "binContents.h"
+#include "binStore.h"
+#include "solutionWriter.h"
+
+SolutionWriter solutionOut;
 
 class Item 
 {
@@ -11,43 +21,106 @@ public:
     Item(int _id, int _size) : id(_id), size(_size) {}
 };
 
-class Bin 
+const FitScan firstFit = selectFirstFit();
+
+// Max tree over blocks of BinStore::kLane bins. Only used above kTreeThreshold bins,
+// below that one SIMD scan of the remaining array is faster than walking the tree.
+// A search walks down to the first block that holds a fitting bin and scans only it.
+class FirstFitIndex
 {
 public:
-    std::vector<Item> items;
-    int capacity;
+    static constexpr int kTreeThreshold = 512;
 
-    Bin(int _capacity) : capacity(_capacity) {}
+    FirstFitIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : tree_(resource) {}
 
-    bool addItem(const Item& item) {
-        if (currentCapacity() + item.size <= capacity) 
+    // Call after the bins were reset.
+    void rebuild(const BinStore& bins)
+    {
+        int numBlocks = (bins.getNumBins() + BinStore::kLane - 1) / BinStore::kLane;
+        active_ = bins.getNumBins() > kTreeThreshold;
+        if (!active_)
+        {
+            return;
+        }
+        leaves_ = 1;
+        while (leaves_ < numBlocks)
+        {
+            leaves_ *= 2;
+        }
+        tree_.assign(2 * leaves_, -1);
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            tree_[leaves_ + block] = blockMax(bins, block);
+        }
+        for (int node = leaves_ - 1; node >= 1; --node)
         {
-            items.push_back(item);
-            return true;
+            tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
         }
-        return false;
     }
 
-    int currentCapacity() const 
+    // Call after the remaining capacity of bin changed or bin was opened.
+    void update(const BinStore& bins, int bin)
     {
-        int usedCapacity = 0;
-        for (const auto& item : items) 
+        int block = bin / BinStore::kLane;
+        if (!active_ || block >= leaves_)
         {
-            usedCapacity += item.size;
+            if (bins.getNumBins() > kTreeThreshold)
+            {
+                rebuild(bins);
+            }
+            return;
+        }
+        int node = leaves_ + block;
+        tree_[node] = blockMax(bins, block);
+        for (node /= 2; node >= 1; node /= 2)
+        {
+            tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
         }
-        return usedCapacity;
     }
 
-    bool isFull() const 
+    // First bin with remaining >= size, or -1.
+    int find(const BinStore& bins, int32_t size) const
     {
-        return currentCapacity() == capacity;
+        if (!active_)
+        {
+            return firstFit(bins.remaining(), bins.getNumBins(), size);
+        }
+        if (tree_[1] < size)
+        {
+            return -1;
+        }
+        int node = 1;
+        while (node < leaves_)
+        {
+            node = tree_[2 * node] >= size ? 2 * node : 2 * node + 1;
+        }
+        int first = (node - leaves_) * BinStore::kLane;
+        return first + firstFit(bins.remaining() + first, BinStore::kLane, size);
     }
+
+private:
+    static int32_t blockMax(const BinStore& bins, int block)
+    {
+        const int32_t* remaining = bins.remaining() + block * BinStore::kLane;
+        int32_t result = -1;
+        for (int b = 0; b < BinStore::kLane; ++b)
+        {
+            result = std::max(result, remaining[b]);
+        }
+        return result;
+    }
+
+    std::pmr::vector<int32_t> tree_;
+    int leaves_ = 0;
+    bool active_ = false;
 };
 
 class Multibin 
 {
 public:
-    Multibin(int maxBins, int incrementStrategy) : maxBins(maxBins), incrementStrategy(incrementStrategy) {}
+    Multibin(int maxBins, int incrementStrategy, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : maxBins(maxBins), incrementStrategy(incrementStrategy), resource(resource),
+          items(resource), binOfItem(resource), binOfSlot(resource), contents(resource) {}
 
     void addItem(const Item& item) 
     {
@@ -56,14 +129,19 @@ public:
 
     bool packItems() 
     {
+        // The bins of every attempt come from one arena that is released at once when the run ends.
+        std::pmr::monotonic_buffer_resource arena(resource);
+        BinStore activeBins(binCapacity, &arena);
+        FirstFitIndex index(&arena);
         int n = 1; 
         while (n <= maxBins) 
         {
-            std::vector<Bin> activeBins(n, Bin(binCapacity));
-            bool success = packItemsIntoBins(activeBins);
+            activeBins.reset(n);
+            index.rebuild(activeBins);
+            bool success = packItemsIntoBins(activeBins, index);
             if (success) 
             {
-                bins = activeBins;
+                contents.build(binOfItem, n);
                 return true;
             }
 
@@ -81,27 +159,53 @@ public:
     }
 
   
-    bool packItemsIntoBins(std::vector<Bin>& bins)
+    bool packItemsIntoBins(BinStore& bins, FirstFitIndex& index)
     {
         sort(items.begin(), items.end(), [](const Item& a, const Item& b) 
             {
             return a.size > b.size;
             });
 
-        for (const auto& item : items)
+        binOfItem.assign(items.size(), -1);
+        binOfSlot.resize(bins.getNumBins());
+        std::iota(binOfSlot.begin(), binOfSlot.end(), 0);
+
+        // No later item is smaller than the last one, a bin whose remaining capacity drops
+        // below it is retired. Retired slots are dropped from the scan set once they are
+        // half of it, the open bins keep their order so the choice of bin does not change.
+        int32_t smallest = items.empty() ? 0 : items.back().size;
+        int retired = 0;
+        for (size_t k = 0; k < items.size(); ++k)
         {
-            bool itemPacked = false;
-            for (auto& bin : bins)
+            const Item& item = items[k];
+            int slot = index.find(bins, item.size);
+            if (slot == -1)
             {
-                if (!bin.isFull() && bin.addItem(item))
-                {
-                    itemPacked = true;
-                    break;
-                }
+                return false;
             }
-            if (!itemPacked)
+            bins.addItem(slot, item.size);
+            binOfItem[k] = binOfSlot[slot];
+            if (bins.getRemaining(slot) < smallest)
             {
-                return false;
+                bins.closeBin(slot);
+                ++retired;
+            }
+            index.update(bins, slot);
+
+            if (retired >= BinStore::kLane && 2 * retired >= bins.getNumBins())
+            {
+                int kept = 0;
+                for (int b = 0; b < bins.getNumBins(); ++b)
+                {
+                    if (bins.getRemaining(b) != -1)
+                    {
+                        binOfSlot[kept++] = binOfSlot[b];
+                    }
+                }
+                binOfSlot.resize(kept);
+                bins.removeClosed();
+                index.rebuild(bins);
+                retired = 0;
             }
         }
         return true;
@@ -109,14 +213,15 @@ public:
 
     void printBins() const 
     {
-        for (int i = 0; i < bins.size(); i++) 
+        for (int i = 0; !solutionOut.isQuiet() && i < contents.getNumBins(); i++) 
         {
-            std::cout << "Bin " << i + 1 << ": ";
-            for (const auto& item : bins[i].items) 
+            solutionOut << "Bin " << i + 1 << ": ";
+            for (int id : contents.getItems(i))
             {
-                std::cout << "Item " << item.id << " (Size: " << item.size << ") ";
+                const Item& item = items[id];
+                solutionOut << "Item " << item.id << " (Size: " << item.size << ") ";
             }
-            std::cout << std::endl;
+            solutionOut << '\n';
         }
     }
 
@@ -124,12 +229,17 @@ private:
     int maxBins;
     int incrementStrategy;
     int binCapacity = 100; 
-    std::vector<Item> items;
-    std::vector<Bin> bins;
+    std::pmr::memory_resource* resource;
+    std::pmr::vector<Item> items;
+    std::pmr::vector<int> binOfItem;
+    std::pmr::vector<int> binOfSlot;
+    BinContents contents;
 };
 
-int main() 
+int main(int argc, char** argv)
 {
+    // --quiet skips the bin listings
+    solutionOut.setQuiet(argc > 1 && std::string(argv[1]) == "--quiet");
 
     int maxBins = 4;
     int batchIncrement = 1;
@@ -150,12 +260,12 @@ int main()
     bool success = multibin.packItems();
     if (success) 
     {
-        std::cout << "Successfully packed items into bins!" << std::endl;
+        solutionOut << "Successfully packed items into bins!" << '\n';
         multibin.printBins();
     }
     else 
     {
-        std::cout << "Failed to find a solution with the maximum number of bins." << std::endl;
+        solutionOut << "Failed to find a solution with the maximum number of bins." << '\n';
     }
 
     return 0;
@@ -1,6 +1,16 @@
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include<algorithm>
+#include <numeric>
+#include <cstdint>
+#include <string>
+
+#include "binContents.h"
+#include "binStore.h"
+#include "solutionWriter.h"
+
+SolutionWriter solutionOut;
 
 class Item 
 {
@@ -11,43 +21,106 @@ public:
     Item(int _id, int _size) : id(_id), size(_size) {}
 };
 
-class Bin 
+const FitScan worstFit = selectWorstFit();
+
+// Max tree over blocks of BinStore::kLane bins. Only used above kTreeThreshold bins,
+// below that one SIMD scan of the remaining array is faster than walking the tree.
+// A search walks down to the first block that holds a fitting bin and scans only it.
+class WorstFitIndex
 {
 public:
-    std::vector<Item> items;
-    int capacity;
+    static constexpr int kTreeThreshold = 256;
 
-    Bin(int _capacity) : capacity(_capacity) {}
+    WorstFitIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : tree_(resource) {}
+
+    // Call after the bins were reset.
+    void rebuild(const BinStore& bins)
+    {
+        int numBlocks = (bins.getNumBins() + BinStore::kLane - 1) / BinStore::kLane;
+        active_ = bins.getNumBins() > kTreeThreshold;
+        if (!active_)
+        {
+            return;
+        }
+        leaves_ = 1;
+        while (leaves_ < numBlocks)
+        {
+            leaves_ *= 2;
+        }
+        tree_.assign(2 * leaves_, -1);
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            tree_[leaves_ + block] = blockMax(bins, block);
+        }
+        for (int node = leaves_ - 1; node >= 1; --node)
+        {
+            tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+        }
+    }
 
-    bool addItem(const Item& item) {
-        if (currentCapacity() + item.size <= capacity) 
+    // Call after the remaining capacity of bin changed or bin was opened.
+    void update(const BinStore& bins, int bin)
+    {
+        int block = bin / BinStore::kLane;
+        if (!active_ || block >= leaves_)
+        {
+            if (bins.getNumBins() > kTreeThreshold)
+            {
+                rebuild(bins);
+            }
+            return;
+        }
+        int node = leaves_ + block;
+        tree_[node] = blockMax(bins, block);
+        for (node /= 2; node >= 1; node /= 2)
         {
-            items.push_back(item);
-            return true;
+            tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
         }
-        return false;
     }
 
-    int currentCapacity() const 
+    // Bin with the largest remaining, the first one on ties, if it holds size; or -1.
+    int find(const BinStore& bins, int32_t size) const
     {
-        int usedCapacity = 0;
-        for (const auto& item : items) 
+        if (!active_)
+        {
+            return worstFit(bins.remaining(), bins.getNumBins(), size);
+        }
+        if (tree_[1] < size)
+        {
+            return -1;
+        }
+        int node = 1;
+        while (node < leaves_)
         {
-            usedCapacity += item.size;
+            node = tree_[2 * node] == tree_[1] ? 2 * node : 2 * node + 1;
         }
-        return usedCapacity;
+        int first = (node - leaves_) * BinStore::kLane;
+        return first + worstFit(bins.remaining() + first, BinStore::kLane, size);
     }
 
-    bool isFull() const 
+private:
+    static int32_t blockMax(const BinStore& bins, int block)
     {
-        return currentCapacity() == capacity;
+        const int32_t* remaining = bins.remaining() + block * BinStore::kLane;
+        int32_t result = -1;
+        for (int b = 0; b < BinStore::kLane; ++b)
+        {
+            result = std::max(result, remaining[b]);
+        }
+        return result;
     }
+
+    std::pmr::vector<int32_t> tree_;
+    int leaves_ = 0;
+    bool active_ = false;
 };
 
 class Multibin 
 {
 public:
-    Multibin(int maxBins, int incrementStrategy) : maxBins(maxBins), incrementStrategy(incrementStrategy) {}
+    Multibin(int maxBins, int incrementStrategy, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : maxBins(maxBins), incrementStrategy(incrementStrategy), resource(resource),
+          items(resource), binOfItem(resource), binOfSlot(resource), contents(resource) {}
 
     void addItem(const Item& item) 
     {
@@ -56,14 +129,18 @@ public:
 
     bool packItems() 
     {
+        std::pmr::monotonic_buffer_resource arena(resource);
+        BinStore activeBins(binCapacity, &arena);
+        WorstFitIndex index(&arena);
         int n = 1; 
         while (n <= maxBins) 
         {
-            std::vector<Bin> activeBins(n, Bin(binCapacity));
-            bool success = packItemsIntoBins(activeBins);
+            activeBins.reset(n);
+            index.rebuild(activeBins);
+            bool success = packItemsIntoBins(activeBins, index);
             if (success) 
             {
-                bins = activeBins;
+                contents.build(binOfItem, n);
                 return true;
             }
 
@@ -81,38 +158,53 @@ public:
     }
 
   
-    bool packItemsIntoBins(std::vector<Bin>& bins) 
+    bool packItemsIntoBins(BinStore& bins, WorstFitIndex& index) 
     {
         sort(items.begin(), items.end(), [](const Item& a, const Item& b) 
         {
             return a.size > b.size; // sort items in descending order
         });
 
-        for (const auto& item : items) 
-        {
-            bool itemPacked = false;
-            int bestFitBinIdx = -1;
-            int maxRemainingSpace = binCapacity + 1; 
+        binOfItem.assign(items.size(), -1);
+        binOfSlot.resize(bins.getNumBins());
+        std::iota(binOfSlot.begin(), binOfSlot.end(), 0);
 
-            for (int i = 0; i < bins.size(); ++i) 
+        // No later item is smaller than the last one, a bin whose remaining capacity drops
+        // below it is retired. Retired slots are dropped from the scan set once they are
+        // half of it, the open bins keep their order so the choice of bin does not change.
+        int32_t smallest = items.empty() ? 0 : items.back().size;
+        int retired = 0;
+        for (size_t k = 0; k < items.size(); ++k)
+        {
+            const Item& item = items[k];
+            int slot = index.find(bins, item.size);
+            if (slot == -1)
             {
-                int remainingSpace = bins[i].capacity - bins[i].currentCapacity();
-                if (remainingSpace >= item.size && remainingSpace > maxRemainingSpace) 
-                {
-                    bestFitBinIdx = i;
-                    maxRemainingSpace = remainingSpace;
-                }
+                return false;
             }
-
-            if (bestFitBinIdx != -1) 
+            bins.addItem(slot, item.size);
+            binOfItem[k] = binOfSlot[slot];
+            if (bins.getRemaining(slot) < smallest)
             {
-                bins[bestFitBinIdx].addItem(item);
-                itemPacked = true;
+                bins.closeBin(slot);
+                ++retired;
             }
+            index.update(bins, slot);
 
-            if (!itemPacked) 
+            if (retired >= BinStore::kLane && 2 * retired >= bins.getNumBins())
             {
-                return false;
+                int kept = 0;
+                for (int b = 0; b < bins.getNumBins(); ++b)
+                {
+                    if (bins.getRemaining(b) != -1)
+                    {
+                        binOfSlot[kept++] = binOfSlot[b];
+                    }
+                }
+                binOfSlot.resize(kept);
+                bins.removeClosed();
+                index.rebuild(bins);
+                retired = 0;
             }
         }
         return true; 
@@ -120,14 +212,15 @@ public:
 
     void printBins() const 
     {
-        for (int i = 0; i < bins.size(); i++) 
+        for (int i = 0; !solutionOut.isQuiet() && i < contents.getNumBins(); i++) 
         {
-            std::cout << "Bin " << i + 1 << ": ";
-            for (const auto& item : bins[i].items) 
+            solutionOut << "Bin " << i + 1 << ": ";
+            for (int id : contents.getItems(i))
             {
-                std::cout << "Item " << item.id << " (Size: " << item.size << ") ";
+                const Item& item = items[id];
+                solutionOut << "Item " << item.id << " (Size: " << item.size << ") ";
             }
-            std::cout << std::endl;
+            solutionOut << '\n';
         }
     }
 
@@ -135,12 +228,17 @@ private:
     int maxBins;
     int incrementStrategy;
     int binCapacity = 100; 
-    std::vector<Item> items;
-    std::vector<Bin> bins;
+    std::pmr::memory_resource* resource;
+    std::pmr::vector<Item> items;
+    std::pmr::vector<int> binOfItem;
+    std::pmr::vector<int> binOfSlot;
+    BinContents contents;
 };
 
-int main() 
+int main(int argc, char** argv)
 {
+    // --quiet skips the bin listings
+    solutionOut.setQuiet(argc > 1 && std::string(argv[1]) == "--quiet");
 
     int maxBins = 4;
     int batchIncrement = 1;
@@ -161,12 +259,12 @@ int main()
     bool success = multibin.packItems();
     if (success) 
     {
-        std::cout << "Successfully packed items into bins!" << std::endl;
+        solutionOut << "Successfully packed items into bins!" << '\n';
         multibin.printBins();
     }
     else 
     {
-        std::cout << "Failed to find a solution with the maximum number of bins." << std::endl;
+        solutionOut << "Failed to find a solution with the maximum number of bins." << '\n';
     }
 
     return 0;
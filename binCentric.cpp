@@ -1,87 +1,273 @@
 #include <iostream>
 #include <vector>
+#include <string>
+#include <memory_resource>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include "binContents.h"
+
+// Weights are stored as integer counts of 1 / kWeightScale, so every capacity check is
+// an exact integer compare with the same result on every compiler. The scale is picked
+// at compile time: the default is fixed point with three decimals, build with
+// -DBIN_CENTRIC_WEIGHT_SCALE=1 for plain integer weights.
+#ifndef BIN_CENTRIC_WEIGHT_SCALE
+#define BIN_CENTRIC_WEIGHT_SCALE 1000
+#endif
+
+using Weight = int64_t;
+constexpr Weight kWeightScale = BIN_CENTRIC_WEIGHT_SCALE;
+
+inline Weight toWeight(double weight) { return std::llround(weight * kWeightScale); }
+inline double fromWeight(Weight weight) { return static_cast<double>(weight) / kWeightScale; }
 
 class Item {
 public:
-    Item(double weight, double value) : weight(weight), value(value) {}
+    Item(double weight, double value) : weight(toWeight(weight)), value(value) {}
 
-    double getWeight() const { return weight; }
+    double getWeight() const { return fromWeight(weight); }
+    Weight getScaledWeight() const { return weight; }
     double getValue() const { return value; }
 
 private:
-    double weight;
+    Weight weight;
     double value;
 };
 
+// Bins only keep their totals, which bin every item went to is recorded by the
+// algorithm and turned into BinContents at the end of the run.
 class Bin {
 public:
-    Bin(double capacity) : capacity(capacity), currentWeight(0), totalValue(0) {}
+    Bin(Weight capacity) : capacity(capacity), currentWeight(0), totalValue(0), count(0) {}
 
     bool addItem(const Item& item) {
-        if (currentWeight + item.getWeight() <= capacity) {
-            items.push_back(item);
-            currentWeight += item.getWeight();
+        if (currentWeight + item.getScaledWeight() <= capacity) {
+            currentWeight += item.getScaledWeight();
             totalValue += item.getValue();
+            ++count;
             return true;
         }
         return false;
     }
 
     double getScore() const { return totalValue; }
-    const std::vector<Item>& getItems() const { return items; }
+    int getNumItems() const { return count; }
+    Weight getRemaining() const { return capacity - currentWeight; }
 
 private:
-    double capacity;
-    double currentWeight;
+    Weight capacity;
+    Weight currentWeight;
     double totalValue;
-    std::vector<Item> items;
+    int count;
+};
+
+// Non-owning view of a contiguous array, the C++17 stand-in for std::span.
+template <typename T>
+class Span {
+public:
+    Span(const T* data, size_t size) : data_(data), size_(size) {}
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    size_t size() const { return size_; }
+
+private:
+    const T* data_;
+    size_t size_;
+};
+
+// How runAlgorithm fills the bins.
+//   FirstFit   every item in insertion order goes to the first bin it fits in,
+//   SubsetSum  one bin at a time is filled with the subset of the remaining items whose
+//              total weight is closest to the capacity,
+//   Knapsack   one bin at a time is filled with the subset of the remaining items with
+//              the largest total value that fits.
+// The two DP modes run over weights in units of their greatest common divisor and fall
+// back to FirstFit when the capacity is more than kMaxDpUnits of those.
+enum class FillMode { FirstFit, SubsetSum, Knapsack };
+
+// Subset sums of a set of integer weights as a bitset over 0 .. capacity: bit s is set
+// when some subset weighs exactly s. Adding an item is one shift-or over the words,
+// from[s] records the item that first reached s so the subset can be rebuilt.
+class SubsetSums {
+public:
+    SubsetSums(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : reach_(resource), from_(resource) {}
+
+    void reset(int capacity) {
+        capacity_ = capacity;
+        reach_.assign(capacity / 64 + 1, 0);
+        from_.assign(capacity + 1, -1);
+        reach_[0] = 1;
+    }
+
+    // reach |= reach << weight, the new sums are attributed to item.
+    void add(int item, Weight weight) {
+        if (weight <= 0 || weight > capacity_) {
+            return;
+        }
+        int words = static_cast<int>(reach_.size());
+        int shift = static_cast<int>(weight / 64);
+        int bits = static_cast<int>(weight % 64);
+        uint64_t lastMask = capacity_ % 64 == 63 ? ~0ull : (1ull << (capacity_ % 64 + 1)) - 1;
+        // From the top down, so every source word is read before it is updated.
+        for (int w = words - 1; w >= shift; --w) {
+            uint64_t shifted = reach_[w - shift] << bits;
+            if (bits != 0 && w - shift - 1 >= 0) {
+                shifted |= reach_[w - shift - 1] >> (64 - bits);
+            }
+            if (w == words - 1) {
+                shifted &= lastMask;
+            }
+            uint64_t added = shifted & ~reach_[w];
+            reach_[w] |= shifted;
+            while (added != 0) {
+                from_[w * 64 + __builtin_ctzll(added)] = item;
+                added &= added - 1;
+            }
+        }
+    }
+
+    bool reachable(int sum) const { return (reach_[sum / 64] >> (sum % 64)) & 1; }
+
+    // Largest reachable sum.
+    int best() const {
+        for (int w = static_cast<int>(reach_.size()) - 1; w >= 0; --w) {
+            if (reach_[w] != 0) {
+                return w * 64 + 63 - __builtin_clzll(reach_[w]);
+            }
+        }
+        return 0;
+    }
+
+    // Item that first reached sum, -1 for 0.
+    int from(int sum) const { return from_[sum]; }
+
+private:
+    int capacity_ = 0;
+    std::pmr::vector<uint64_t> reach_;
+    std::pmr::vector<int> from_;
+};
+
+// Result of a run. It owns the items, bins and contents and can only be moved, so handing
+// a solution on never copies item data; readers get views into it.
+class Solution {
+public:
+    Solution(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : items(resource), bins(resource), binOfItem(resource), contents(resource), binScore(resource) {}
+    Solution(const Solution&) = delete;
+    Solution& operator=(const Solution&) = delete;
+
+    Solution(Solution&&) = default;
+    Solution& operator=(Solution&&) = default;
+
+    int getNumBins() const { return static_cast<int>(bins.size()); }
+    Span<Item> getItems() const { return Span<Item>(items.data(), items.size()); }
+    Span<Bin> getBins() const { return Span<Bin>(bins.data(), bins.size()); }
+    Span<int> getBinOfItem() const { return Span<int>(binOfItem.data(), binOfItem.size()); }
+    Span<double> getBinScores() const { return Span<double>(binScore.data(), binScore.size()); }
+    Span<int> getItemIds(int bin) const {
+        BinContents::IdRange ids = contents.getItems(bin);
+        return Span<int>(ids.begin(), ids.size());
+    }
+
+private:
+    friend class BinCentricAlgorithm;
+
+    std::pmr::vector<Item> items;
+    std::pmr::vector<Bin> bins;
+    std::pmr::vector<int> binOfItem;
+    BinContents contents;
+    std::pmr::vector<double> binScore;
 };
 
 class BinCentricAlgorithm {
 public:
-    BinCentricAlgorithm(double binCapacity) : binCapacity(binCapacity) {}
+    static constexpr Weight kMaxDpUnits = Weight(1) << 26;
+    // The knapsack keeps n * C / 64 words for the first bin, 1 GiB at this limit.
+    static constexpr size_t kMaxKnapsackWords = size_t(1) << 27;
+
+    BinCentricAlgorithm(double binCapacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : binCapacity(toWeight(binCapacity)), items(resource), bins(resource), binOfItem(resource), contents(resource), binScore(resource) {}
 
     void addItem(const Item& item) {
         items.push_back(item);
     }
 
-    void runAlgorithm() {
+    void runAlgorithm(FillMode mode = FillMode::FirstFit) {
         bins.clear();
-        for (const Item& item : items) {
-            bool itemAdded = false;
-            for (Bin& bin : bins) {
-                if (bin.addItem(item)) {
-                    itemAdded = true;
-                    break;
-                }
+        binScore.clear();
+        binOfItem.assign(items.size(), -1);
+        Weight unit = weightUnit();
+        Weight units = binCapacity / unit;
+        bool fillByDp = mode != FillMode::FirstFit && units <= kMaxDpUnits;
+        if (fillByDp && mode == FillMode::Knapsack && items.size() * static_cast<size_t>(units / 64 + 1) > kMaxKnapsackWords) {
+            fillByDp = false;
+        }
+        if (fillByDp) {
+            if (mode == FillMode::SubsetSum) {
+                fillBinByBin([&](const std::pmr::vector<int>& remaining, int bin) { fillBySubsetSum(remaining, bin, unit); });
+            } else {
+                fillBinByBin([&](const std::pmr::vector<int>& remaining, int bin) { fillByKnapsack(remaining, bin, unit); });
             }
-            if (!itemAdded) {
-                Bin newBin(binCapacity);
-                newBin.addItem(item);
-                bins.push_back(newBin);
+        } else {
+            for (int i = 0; i < static_cast<int>(items.size()); ++i) {
+                for (int b = 0; b < static_cast<int>(bins.size()); ++b) {
+                    if (placeItem(i, b)) {
+                        break;
+                    }
+                }
+                if (binOfItem[i] == -1) {
+                    int bin = openBin();
+                    if (!placeItem(i, bin)) {
+                        binOfItem[i] = bin;
+                    }
+                }
             }
         }
-    }
-
-    void calculateScores() {
-        for (Bin& bin : bins) {
-            binScore.push_back(bin.getScore());
-        }
+        contents.build(binOfItem, static_cast<int>(bins.size()));
     }
 
     int getNumBinsUsed() const {
         return bins.size();
     }
 
-    std::vector<Bin> getBins() const {
-        return bins;
+    // Score of every bin, kept up to date as items are placed.
+    const std::pmr::vector<double>& getBinScores() const {
+        return binScore;
+    }
+
+    Span<Bin> getBins() const {
+        return Span<Bin>(bins.data(), bins.size());
+    }
+
+    // Moves the items and the result of the last run out, the algorithm is left empty.
+    Solution releaseSolution() {
+        Solution solution(items.get_allocator().resource());
+        solution.items = std::move(items);
+        solution.bins = std::move(bins);
+        solution.binOfItem = std::move(binOfItem);
+        solution.contents = std::move(contents);
+        solution.binScore = std::move(binScore);
+        items.clear();
+        bins.clear();
+        binOfItem.clear();
+        binScore.clear();
+        return solution;
+    }
+
+    const BinContents& getContents() const {
+        return contents;
     }
 
     void printBins() const {
         int binNumber = 1;
         for (const Bin& bin : bins) {
-            std::cout << "Bin " << binNumber++ << ": Score=" << bin.getScore() << ", Items=";
-            for (const Item& item : bin.getItems()) {
+            std::cout << "Bin " << binNumber << ": Score=" << bin.getScore() << ", Items=";
+            for (int id : contents.getItems(binNumber++ - 1)) {
+                const Item& item = items[id];
                 std::cout << "(Weight=" << item.getWeight() << ", Value=" << item.getValue() << ") ";
             }
             std::cout << std::endl;
@@ -96,13 +282,120 @@ public:
     }
 
 private:
-    double binCapacity;
-    std::vector<Item> items;
-    std::vector<Bin> bins;
-    std::vector<double> binScore;
+    int openBin() {
+        bins.push_back(Bin(binCapacity));
+        binScore.push_back(0);
+        return static_cast<int>(bins.size()) - 1;
+    }
+
+    bool placeItem(int item, int bin) {
+        if (!bins[bin].addItem(items[item])) {
+            return false;
+        }
+        binOfItem[item] = bin;
+        binScore[bin] += items[item].getValue();
+        return true;
+    }
+
+    // Opens one bin at a time until every item is placed. fill(remaining, bin) places a
+    // subset of the remaining items into the new bin, whatever capacity it leaves is then
+    // topped up in insertion order. An item heavier than the capacity gets a bin of its own.
+    template <typename Fill>
+    void fillBinByBin(Fill fill) {
+        std::pmr::vector<int> remaining(items.get_allocator());
+        for (int i = 0; i < static_cast<int>(items.size()); ++i) {
+            remaining.push_back(i);
+        }
+        while (!remaining.empty()) {
+            int bin = openBin();
+            fill(remaining, bin);
+            for (int i : remaining) {
+                if (binOfItem[i] == -1) {
+                    placeItem(i, bin);
+                }
+            }
+            if (bins[bin].getNumItems() == 0) {
+                binOfItem[remaining.front()] = bin;
+            }
+            int kept = 0;
+            for (int i : remaining) {
+                if (binOfItem[i] == -1) {
+                    remaining[kept++] = i;
+                }
+            }
+            remaining.resize(kept);
+        }
+    }
+
+    // Subset of the remaining items whose weight is closest to the capacity, as a bitset
+    // DP with one shift-or per item. Costs O(n * C / 64) per bin.
+    void fillBySubsetSum(const std::pmr::vector<int>& remaining, int bin, Weight unit) {
+        int capacity = static_cast<int>(binCapacity / unit);
+        SubsetSums sums(items.get_allocator().resource());
+        sums.reset(capacity);
+        for (int i : remaining) {
+            sums.add(i, items[i].getScaledWeight() / unit);
+            if (sums.reachable(capacity)) {
+                break;
+            }
+        }
+        for (int sum = sums.best(); sum > 0; sum -= static_cast<int>(items[sums.from(sum)].getScaledWeight() / unit)) {
+            placeItem(sums.from(sum), bin);
+        }
+    }
+
+    // 0/1 knapsack over the remaining items: best[c] is the largest value of a subset that
+    // weighs at most c units, bit c of row k is set when item k improved it. Costs
+    // O(n * C) time and n * C bits per bin, runAlgorithm falls back to first fit past
+    // kMaxKnapsackWords.
+    void fillByKnapsack(const std::pmr::vector<int>& remaining, int bin, Weight unit) {
+        int capacity = static_cast<int>(binCapacity / unit);
+        int words = capacity / 64 + 1;
+        std::pmr::vector<double> best(capacity + 1, 0.0, items.get_allocator());
+        std::pmr::vector<uint64_t> took(remaining.size() * words, 0, items.get_allocator());
+        for (int k = 0; k < static_cast<int>(remaining.size()); ++k) {
+            const Item& item = items[remaining[k]];
+            Weight weight = item.getScaledWeight() / unit;
+            uint64_t* row = took.data() + static_cast<size_t>(k) * words;
+            for (int c = capacity; c >= weight; --c) {
+                double value = best[c - weight] + item.getValue();
+                if (value > best[c]) {
+                    best[c] = value;
+                    row[c / 64] |= uint64_t(1) << (c % 64);
+                }
+            }
+        }
+        int c = capacity;
+        for (int k = static_cast<int>(remaining.size()) - 1; k >= 0; --k) {
+            if ((took[static_cast<size_t>(k) * words + c / 64] >> (c % 64)) & 1) {
+                placeItem(remaining[k], bin);
+                c -= static_cast<int>(items[remaining[k]].getScaledWeight() / unit);
+            }
+        }
+    }
+
+    // Greatest common divisor of the capacity and all weights.
+    Weight weightUnit() const {
+        Weight unit = binCapacity;
+        for (const Item& item : items) {
+            unit = std::gcd(unit, item.getScaledWeight());
+        }
+        return unit > 0 ? unit : 1;
+    }
+
+    Weight binCapacity;
+    std::pmr::vector<Item> items;
+    std::pmr::vector<Bin> bins;
+    std::pmr::vector<int> binOfItem;
+    BinContents contents;
+    std::pmr::vector<double> binScore;
 };
 
-int main() {
+int main(int argc, char** argv) {
+    // --subset-sum and --knapsack fill the bins one at a time instead of first fit
+    std::string option = argc > 1 ? argv[1] : "";
+    FillMode mode = option == "--subset-sum" ? FillMode::SubsetSum : (option == "--knapsack" ? FillMode::Knapsack : FillMode::FirstFit);
+
     // Implementing the usage
     BinCentricAlgorithm algorithm(10.0); // Bin capacity is 10.0
 
@@ -113,18 +406,18 @@ int main() {
     algorithm.addItem(Item(5.0, 8.0));
 
 
-    algorithm.runAlgorithm();
-    algorithm.calculateScores();
+    algorithm.runAlgorithm(mode);
     algorithm.printBins();
     algorithm.printBinScores();
 
     // Now here i tell about the bins that are used and their respective items
     std::cout << "Number of bins used: " << algorithm.getNumBinsUsed() << std::endl;
     std::cout << "Bins Contents:" << std::endl;
-    int binNumber = 1;
-    for (const Bin& bin : algorithm.getBins()) {
-        std::cout << "Bin " << binNumber++ << ": ";
-        for (const Item& item : bin.getItems()) {
+    Solution solution = algorithm.releaseSolution();
+    for (int b = 0; b < solution.getNumBins(); ++b) {
+        std::cout << "Bin " << b + 1 << ": ";
+        for (int id : solution.getItemIds(b)) {
+            const Item& item = solution.getItems()[id];
             std::cout << "(Weight=" << item.getWeight() << ", Value=" << item.getValue() << ") ";
         }
         std::cout << std::endl;
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// Final bin contents in compressed sparse row form: the ids of the items of bin b are
+// itemIds_[offsets_[b]] .. itemIds_[offsets_[b + 1] - 1], an id being the index of the item
+// in the caller's item array. The rows are built in one counting pass, either from the bin
+// of every item or from a log that packing appends each placement to.
+class BinContents
+{
+public:
+    class IdRange
+    {
+    public:
+        IdRange(const int* first, const int* last) : first_(first), last_(last) {}
+        const int* begin() const { return first_; }
+        const int* end() const { return last_; }
+        int size() const { return static_cast<int>(last_ - first_); }
+
+    private:
+        const int* first_;
+        const int* last_;
+    };
+
+    BinContents(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : logItems_(resource), logBins_(resource), offsets_(1, 0, resource), itemIds_(resource) {}
+
+    void add(int item, int bin)
+    {
+        logItems_.push_back(item);
+        logBins_.push_back(bin);
+    }
+
+    void clear()
+    {
+        logItems_.clear();
+        logBins_.clear();
+    }
+
+    // Groups the log by bin. Entries of bins at or past numBins were dropped by shrinking
+    // the bins and are skipped.
+    void build(int numBins)
+    {
+        group(logItems_.data(), logBins_.data(), logBins_.size(), numBins);
+    }
+
+    // Groups item i into bin binOfItem[i].
+    void build(const std::pmr::vector<int>& binOfItem, int numBins)
+    {
+        group(nullptr, binOfItem.data(), binOfItem.size(), numBins);
+    }
+
+    int getNumBins() const { return static_cast<int>(offsets_.size()) - 1; }
+
+    IdRange getItems(int bin) const
+    {
+        return IdRange(itemIds_.data() + offsets_[bin], itemIds_.data() + offsets_[bin + 1]);
+    }
+
+    // Writes the bin of items 0 .. numItems - 1 as uint32 values, the format largeInstance
+    // reads through --initial. Empty bins are skipped in the numbering. Fails unless every
+    // item is in exactly one bin.
+    bool writeAssignment(const std::string& path, size_t numItems) const
+    {
+        const uint32_t unassigned = UINT32_MAX;
+        std::pmr::vector<uint32_t> binOf(numItems, unassigned, offsets_.get_allocator());
+        uint32_t used = 0;
+        for (int b = 0; b < getNumBins(); ++b)
+        {
+            for (int id : getItems(b))
+            {
+                if (id < 0 || static_cast<size_t>(id) >= numItems || binOf[id] != unassigned)
+                {
+                    return false;
+                }
+                binOf[id] = used;
+            }
+            used += offsets_[b] < offsets_[b + 1];
+        }
+        if (std::find(binOf.begin(), binOf.end(), unassigned) != binOf.end())
+        {
+            return false;
+        }
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(binOf.data()), binOf.size() * sizeof(uint32_t));
+        return static_cast<bool>(out);
+    }
+
+private:
+    void group(const int* items, const int* bins, size_t count, int numBins)
+    {
+        offsets_.assign(numBins + 1, 0);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (bins[i] < numBins)
+            {
+                ++offsets_[bins[i] + 1];
+            }
+        }
+        for (int b = 0; b < numBins; ++b)
+        {
+            offsets_[b + 1] += offsets_[b];
+        }
+        itemIds_.resize(offsets_[numBins]);
+        std::pmr::vector<int> next(offsets_.begin(), offsets_.end() - 1, offsets_.get_allocator());
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (bins[i] < numBins)
+            {
+                itemIds_[next[bins[i]]++] = items ? items[i] : static_cast<int>(i);
+            }
+        }
+    }
+
+    std::pmr::vector<int> logItems_;
+    std::pmr::vector<int> logBins_;
+    std::pmr::vector<int> offsets_;
+    std::pmr::vector<int> itemIds_;
+};
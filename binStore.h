@@ -0,0 +1,394 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+// Bin state as a structure of arrays. The remaining capacities of all bins live in
+// one contiguous int32_t array, 64-byte aligned and padded to whole cache lines with
+// -1 (a padding slot never fits an item), so a fit scan reads 4 bytes per bin.
+// Item lists and other per-bin data are kept elsewhere.
+class BinStore
+{
+public:
+    static constexpr size_t kAlignment = 64;
+    static constexpr int kLane = kAlignment / sizeof(int32_t);
+
+    BinStore(int32_t capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity), resource_(resource) {}
+
+    BinStore(const BinStore& other) : BinStore(other.capacity_, other.resource_)
+    {
+        *this = other;
+    }
+
+    // Copies the bins but keeps this store's memory resource.
+    BinStore& operator=(const BinStore& other)
+    {
+        if (this != &other)
+        {
+            capacity_ = other.capacity_;
+            numBins_ = 0;
+            reserve(other.numBins_);
+            std::copy(other.remaining_, other.remaining_ + other.numBins_, remaining_);
+            std::fill(remaining_ + other.numBins_, remaining_ + allocated_, -1);
+            numBins_ = other.numBins_;
+        }
+        return *this;
+    }
+
+    ~BinStore()
+    {
+        if (remaining_ != nullptr)
+        {
+            resource_->deallocate(remaining_, allocated_ * sizeof(int32_t), kAlignment);
+        }
+    }
+
+    int getNumBins() const { return numBins_; }
+    int32_t getCapacity() const { return capacity_; }
+    const int32_t* remaining() const { return remaining_; }
+    int32_t getRemaining(int bin) const { return remaining_[bin]; }
+
+    // Drops every bin and opens numBins empty ones.
+    void reset(int numBins)
+    {
+        reserve(numBins);
+        std::fill(remaining_, remaining_ + numBins, capacity_);
+        std::fill(remaining_ + numBins, remaining_ + allocated_, -1);
+        numBins_ = numBins;
+    }
+
+    int openBin()
+    {
+        if (numBins_ == allocated_)
+        {
+            reserve(std::max(kLane, allocated_ * 2));
+        }
+        remaining_[numBins_] = capacity_;
+        return numBins_++;
+    }
+
+    void addItem(int bin, int32_t size)
+    {
+        remaining_[bin] -= size;
+    }
+
+    // A closed bin keeps its slot until removeClosed() but never fits an item again.
+    void closeBin(int bin)
+    {
+        remaining_[bin] = -1;
+    }
+
+    // Drops the closed bins, the open ones keep their order.
+    void removeClosed()
+    {
+        int kept = 0;
+        for (int b = 0; b < numBins_; ++b)
+        {
+            if (remaining_[b] != -1)
+            {
+                remaining_[kept++] = remaining_[b];
+            }
+        }
+        std::fill(remaining_ + kept, remaining_ + numBins_, -1);
+        numBins_ = kept;
+    }
+
+private:
+    void reserve(int numBins)
+    {
+        if (numBins <= allocated_)
+        {
+            return;
+        }
+        int allocated = (numBins + kLane - 1) / kLane * kLane;
+        int32_t* remaining = static_cast<int32_t*>(resource_->allocate(allocated * sizeof(int32_t), kAlignment));
+        std::copy(remaining_, remaining_ + numBins_, remaining);
+        std::fill(remaining + numBins_, remaining + allocated, -1);
+        if (remaining_ != nullptr)
+        {
+            resource_->deallocate(remaining_, allocated_ * sizeof(int32_t), kAlignment);
+        }
+        remaining_ = remaining;
+        allocated_ = allocated;
+    }
+
+    int32_t capacity_;
+    std::pmr::memory_resource* resource_;
+    int32_t* remaining_ = nullptr;
+    int numBins_ = 0;
+    int allocated_ = 0;
+};
+
+// Fit-scan kernels over a BinStore remaining array. The array is 64-byte aligned and
+// padded with -1 to whole lines, so the vector kernels read whole registers without
+// a tail loop. The widest kernel the CPU supports is picked once at startup, the
+// scalar kernel is the fallback on other CPUs and compilers.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FIT_SCAN_X86
+#endif
+
+using FitScan = int (*)(const int32_t* remaining, int numBins, int32_t size);
+
+// First bin with remaining >= size, or -1.
+inline int firstFitScalar(const int32_t* remaining, int numBins, int32_t size)
+{
+    for (int b = 0; b < numBins; ++b)
+    {
+        if (remaining[b] >= size)
+        {
+            return b;
+        }
+    }
+    return -1;
+}
+
+#ifdef FIT_SCAN_X86
+__attribute__((target("avx2"))) inline int firstFitAvx2(const int32_t* remaining, int numBins, int32_t size)
+{
+    const __m256i threshold = _mm256_set1_epi32(size - 1);
+    for (int b = 0; b < numBins; b += 8)
+    {
+        __m256i r = _mm256_load_si256(reinterpret_cast<const __m256i*>(remaining + b));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(r, threshold)));
+        if (mask != 0)
+        {
+            int bin = b + __builtin_ctz(mask);
+            return bin < numBins ? bin : -1;
+        }
+    }
+    return -1;
+}
+
+__attribute__((target("avx512f"))) inline int firstFitAvx512(const int32_t* remaining, int numBins, int32_t size)
+{
+    const __m512i threshold = _mm512_set1_epi32(size);
+    for (int b = 0; b < numBins; b += 16)
+    {
+        __mmask16 mask = _mm512_cmpge_epi32_mask(_mm512_load_si512(remaining + b), threshold);
+        if (mask != 0)
+        {
+            int bin = b + __builtin_ctz(mask);
+            return bin < numBins ? bin : -1;
+        }
+    }
+    return -1;
+}
+#endif
+
+inline FitScan selectFirstFit()
+{
+#ifdef FIT_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return firstFitAvx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return firstFitAvx2;
+    }
+#endif
+    return firstFitScalar;
+}
+
+// Bin with the smallest remaining >= size, the first one on ties, or -1.
+inline int bestFitScalar(const int32_t* remaining, int numBins, int32_t size)
+{
+    int best = -1;
+    for (int b = 0; b < numBins; ++b)
+    {
+        if (remaining[b] >= size && (best == -1 || remaining[b] < remaining[best]))
+        {
+            best = b;
+        }
+    }
+    return best;
+}
+
+#ifdef FIT_SCAN_X86
+// Lane-wise running minimum of the fitting residuals and its first index, then a
+// scalar reduction over the lanes. Bins that do not fit count as INT32_MAX.
+__attribute__((target("avx2"))) inline int bestFitAvx2(const int32_t* remaining, int numBins, int32_t size)
+{
+    const __m256i threshold = _mm256_set1_epi32(size - 1);
+    const __m256i none = _mm256_set1_epi32(INT32_MAX);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i best = none;
+    __m256i bestIndex = _mm256_set1_epi32(-1);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (int b = 0; b < numBins; b += 8)
+    {
+        __m256i r = _mm256_load_si256(reinterpret_cast<const __m256i*>(remaining + b));
+        __m256i candidate = _mm256_blendv_epi8(none, r, _mm256_cmpgt_epi32(r, threshold));
+        __m256i better = _mm256_cmpgt_epi32(best, candidate);
+        best = _mm256_blendv_epi8(best, candidate, better);
+        bestIndex = _mm256_blendv_epi8(bestIndex, index, better);
+        index = _mm256_add_epi32(index, step);
+    }
+    alignas(32) int32_t values[8];
+    alignas(32) int32_t indices[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(values), best);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indices), bestIndex);
+    int result = -1;
+    for (int lane = 0; lane < 8; ++lane)
+    {
+        if (indices[lane] != -1 && (result == -1 || values[lane] < remaining[result]
+            || (values[lane] == remaining[result] && indices[lane] < result)))
+        {
+            result = indices[lane];
+        }
+    }
+    return result;
+}
+
+__attribute__((target("avx512f"))) inline int bestFitAvx512(const int32_t* remaining, int numBins, int32_t size)
+{
+    const __m512i threshold = _mm512_set1_epi32(size);
+    const __m512i none = _mm512_set1_epi32(INT32_MAX);
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i best = none;
+    __m512i bestIndex = _mm512_set1_epi32(INT32_MAX);
+    __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __mmask16 found = 0;
+    for (int b = 0; b < numBins; b += 16)
+    {
+        __m512i r = _mm512_load_si512(remaining + b);
+        __mmask16 fits = _mm512_cmpge_epi32_mask(r, threshold);
+        __mmask16 better = _mm512_mask_cmplt_epi32_mask(fits, r, best);
+        best = _mm512_mask_blend_epi32(better, best, r);
+        bestIndex = _mm512_mask_blend_epi32(better, bestIndex, index);
+        found |= better;
+        index = _mm512_add_epi32(index, step);
+    }
+    alignas(64) int32_t values[16];
+    alignas(64) int32_t indices[16];
+    _mm512_store_si512(values, best);
+    _mm512_store_si512(indices, bestIndex);
+    int result = -1;
+    for (int lane = 0; lane < 16; ++lane)
+    {
+        if ((found >> lane & 1) && (result == -1 || values[lane] < remaining[result]
+            || (values[lane] == remaining[result] && indices[lane] < result)))
+        {
+            result = indices[lane];
+        }
+    }
+    return result;
+}
+#endif
+
+inline FitScan selectBestFit()
+{
+#ifdef FIT_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return bestFitAvx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return bestFitAvx2;
+    }
+#endif
+    return bestFitScalar;
+}
+
+// Bin with the largest remaining, the first one on ties, if it holds the item; or -1.
+inline int worstFitScalar(const int32_t* remaining, int numBins, int32_t size)
+{
+    int worst = -1;
+    for (int b = 0; b < numBins; ++b)
+    {
+        if (remaining[b] >= size && (worst == -1 || remaining[b] > remaining[worst]))
+        {
+            worst = b;
+        }
+    }
+    return worst;
+}
+
+#ifdef FIT_SCAN_X86
+// Lane-wise running maximum and its first index, then a scalar reduction over the
+// lanes. Padding slots are -1 and never win against a real bin.
+__attribute__((target("avx2"))) inline int worstFitAvx2(const int32_t* remaining, int numBins, int32_t size)
+{
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i worst = _mm256_set1_epi32(INT32_MIN);
+    __m256i worstIndex = _mm256_set1_epi32(INT32_MAX);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (int b = 0; b < numBins; b += 8)
+    {
+        __m256i r = _mm256_load_si256(reinterpret_cast<const __m256i*>(remaining + b));
+        __m256i better = _mm256_cmpgt_epi32(r, worst);
+        worst = _mm256_blendv_epi8(worst, r, better);
+        worstIndex = _mm256_blendv_epi8(worstIndex, index, better);
+        index = _mm256_add_epi32(index, step);
+    }
+    alignas(32) int32_t values[8];
+    alignas(32) int32_t indices[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(values), worst);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indices), worstIndex);
+    int result = -1;
+    for (int lane = 0; lane < 8; ++lane)
+    {
+        if (indices[lane] < numBins && (result == -1 || values[lane] > remaining[result]
+            || (values[lane] == remaining[result] && indices[lane] < result)))
+        {
+            result = indices[lane];
+        }
+    }
+    return result != -1 && remaining[result] >= size ? result : -1;
+}
+
+__attribute__((target("avx512f"))) inline int worstFitAvx512(const int32_t* remaining, int numBins, int32_t size)
+{
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i worst = _mm512_set1_epi32(INT32_MIN);
+    __m512i worstIndex = _mm512_set1_epi32(INT32_MAX);
+    __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    for (int b = 0; b < numBins; b += 16)
+    {
+        __m512i r = _mm512_load_si512(remaining + b);
+        __mmask16 better = _mm512_cmpgt_epi32_mask(r, worst);
+        worst = _mm512_mask_blend_epi32(better, worst, r);
+        worstIndex = _mm512_mask_blend_epi32(better, worstIndex, index);
+        index = _mm512_add_epi32(index, step);
+    }
+    alignas(64) int32_t values[16];
+    alignas(64) int32_t indices[16];
+    _mm512_store_si512(values, worst);
+    _mm512_store_si512(indices, worstIndex);
+    int result = -1;
+    for (int lane = 0; lane < 16; ++lane)
+    {
+        if (indices[lane] < numBins && (result == -1 || values[lane] > remaining[result]
+            || (values[lane] == remaining[result] && indices[lane] < result)))
+        {
+            result = indices[lane];
+        }
+    }
+    return result != -1 && remaining[result] >= size ? result : -1;
+}
+#endif
+
+inline FitScan selectWorstFit()
+{
+#ifdef FIT_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return worstFitAvx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return worstFitAvx2;
+    }
+#endif
+    return worstFitScalar;
+}
@@ -0,0 +1,394 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <thread>
+#include <algorithm>
+
+// Native replacement for create_multi_dim.py.
+//
+// Usage:
+//   create_multi_dim <uniform|triplet|falkenauer_u> <n> <dim> <cap1,cap2,...> [options]
+// Options:
+//   --seed S       base seed of the counter-based generator (default 0)
+//   --id K         instance id, mixed into the seed and the default file name
+//   --threads T    number of formatting threads (default: hardware concurrency)
+//   --binary       write the binary instance format instead of text .vbp
+//   --min A --max B  item size range for falkenauer_u (default 20..100)
+//   -o PATH        output file, "-" for stdout (default: data/Multidim/<u|t>/...)
+//
+// The text format is the one written by create_multi_dim.py: number of dimensions,
+// capacities, number of items, then one line of sizes per item.
+// The binary format is: "VBPB", uint32 dim, uint64 n, uint32 capacity[dim],
+// then uint32 size[n][dim] in native byte order.
+//
+// Every random draw is a pure function of (seed, counter), so any block of items can
+// be generated independently of the others and the output does not depend on the
+// number of threads.
+
+static uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+class CounterRng
+{
+public:
+    CounterRng(uint64_t seed) : key_(splitmix64(seed)) {}
+
+    uint64_t at(uint64_t counter) const { return splitmix64(key_ ^ splitmix64(counter)); }
+
+    // Uniform integer in [lo, hi], same bounds as Python's random.randint.
+    uint32_t randint(uint64_t counter, uint32_t lo, uint32_t hi) const
+    {
+        uint64_t range = static_cast<uint64_t>(hi) - lo + 1;
+        return lo + static_cast<uint32_t>((static_cast<unsigned __int128>(at(counter)) * range) >> 64);
+    }
+
+private:
+    uint64_t key_;
+};
+
+enum class Distribution { Uniform, Triplet, FalkenauerU };
+
+struct GeneratorConfig
+{
+    Distribution distribution = Distribution::Uniform;
+    uint64_t n = 0;
+    uint32_t dim = 1;
+    std::vector<uint32_t> capacities;
+    uint64_t seed = 0;
+    int id = -1;
+    unsigned threads = 0;
+    bool binary = false;
+    uint32_t minSize = 20;
+    uint32_t maxSize = 100;
+    std::string output;
+};
+
+class InstanceGenerator
+{
+public:
+    InstanceGenerator(const GeneratorConfig& config)
+        : config_(config), rng_(config.seed * 0x100000001B3ull + static_cast<uint64_t>(config.id + 1)) {}
+
+    // Writes the sizes of item i into out[0 .. dim-1].
+    void generateItem(uint64_t i, uint32_t* out) const
+    {
+        const uint32_t dim = config_.dim;
+        switch (config_.distribution)
+        {
+        case Distribution::Uniform:
+            for (uint32_t d = 0; d < dim; ++d)
+            {
+                out[d] = rng_.randint(i * dim + d, 1, config_.capacities[d]);
+            }
+            break;
+        case Distribution::FalkenauerU:
+            for (uint32_t d = 0; d < dim; ++d)
+            {
+                out[d] = rng_.randint(i * dim + d, config_.minSize, config_.maxSize);
+            }
+            break;
+        case Distribution::Triplet:
+        {
+            // Same as decomposition() in create_multi_dim.py: the three items of a bin
+            // are drawn together, item k of bin b takes part k of every dimension.
+            uint64_t bin = i / 3;
+            uint64_t part = i % 3;
+            for (uint32_t d = 0; d < dim; ++d)
+            {
+                uint64_t counter = (bin * dim + d) * 2;
+                uint32_t rest = config_.capacities[d];
+                uint32_t first = rng_.randint(counter, rest / 2, rest);
+                rest -= first;
+                uint32_t second = rng_.randint(counter + 1, rest / 2, rest);
+                rest -= second;
+                out[d] = part == 0 ? first : (part == 1 ? second : rest);
+            }
+            break;
+        }
+        }
+    }
+
+    bool write(std::ostream& out) const
+    {
+        writeHeader(out);
+
+        const uint64_t blockItems = 1 << 18;
+        unsigned threads = config_.threads != 0 ? config_.threads : std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::vector<char>> buffers(threads);
+        std::vector<size_t> used(threads);
+
+        for (uint64_t start = 0; start < config_.n; start += blockItems * threads)
+        {
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t)
+            {
+                uint64_t first = start + t * blockItems;
+                uint64_t last = std::min(config_.n, first + blockItems);
+                used[t] = 0;
+                if (first >= last)
+                {
+                    continue;
+                }
+                workers.emplace_back([this, first, last, &buffers, &used, t]() {
+                    used[t] = config_.binary ? formatBinary(first, last, buffers[t])
+                                             : formatText(first, last, buffers[t]);
+                });
+            }
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+            for (unsigned t = 0; t < threads; ++t)
+            {
+                out.write(buffers[t].data(), used[t]);
+            }
+            if (!out)
+            {
+                return false;
+            }
+        }
+        out.flush();
+        return static_cast<bool>(out);
+    }
+
+private:
+    void writeHeader(std::ostream& out) const
+    {
+        if (config_.binary)
+        {
+            uint32_t dim = config_.dim;
+            uint64_t n = config_.n;
+            out.write("VBPB", 4);
+            out.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+            out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+            out.write(reinterpret_cast<const char*>(config_.capacities.data()), dim * sizeof(uint32_t));
+            return;
+        }
+        out << config_.dim << "\n";
+        for (uint32_t capacity : config_.capacities)
+        {
+            out << capacity << " ";
+        }
+        out << "\n" << config_.n << "\n";
+    }
+
+    size_t formatText(uint64_t first, uint64_t last, std::vector<char>& buffer) const
+    {
+        // At most 10 digits and a space per value, plus the newline.
+        buffer.resize((last - first) * (config_.dim * 11 + 1));
+        std::vector<uint32_t> sizes(config_.dim);
+        char* pos = buffer.data();
+        char* end = buffer.data() + buffer.size();
+        for (uint64_t i = first; i < last; ++i)
+        {
+            generateItem(i, sizes.data());
+            for (uint32_t size : sizes)
+            {
+                pos = std::to_chars(pos, end, size).ptr;
+                *pos++ = ' ';
+            }
+            *pos++ = '\n';
+        }
+        return pos - buffer.data();
+    }
+
+    size_t formatBinary(uint64_t first, uint64_t last, std::vector<char>& buffer) const
+    {
+        size_t bytes = (last - first) * config_.dim * sizeof(uint32_t);
+        buffer.resize(bytes);
+        uint32_t* sizes = reinterpret_cast<uint32_t*>(buffer.data());
+        for (uint64_t i = first; i < last; ++i)
+        {
+            generateItem(i, sizes + (i - first) * config_.dim);
+        }
+        return bytes;
+    }
+
+    GeneratorConfig config_;
+    CounterRng rng_;
+};
+
+static std::vector<uint32_t> parseCapacities(const std::string& text)
+{
+    std::vector<uint32_t> capacities;
+    const char* pos = text.data();
+    const char* end = text.data() + text.size();
+    while (pos < end)
+    {
+        uint32_t value = 0;
+        auto result = std::from_chars(pos, end, value);
+        if (result.ec != std::errc())
+        {
+            return {};
+        }
+        capacities.push_back(value);
+        pos = result.ptr;
+        if (pos < end && *pos == ',')
+        {
+            ++pos;
+        }
+    }
+    return capacities;
+}
+
+static std::string defaultOutputPath(const GeneratorConfig& config)
+{
+    std::string name;
+    switch (config.distribution)
+    {
+    case Distribution::Uniform: name = "data/Multidim/u/uniform_instance_"; break;
+    case Distribution::Triplet: name = "data/Multidim/t/triplet_instance_"; break;
+    case Distribution::FalkenauerU: name = "data/Multidim/u/falkenauer_u_instance_"; break;
+    }
+    name += std::to_string(config.n) + "_" + std::to_string(config.dim);
+    if (config.id >= 0)
+    {
+        name += "_" + std::to_string(config.id);
+    }
+    return name + (config.binary ? ".vbpb" : ".vbp");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 5)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " <uniform|triplet|falkenauer_u> <n> <dim> <cap1,cap2,...>"
+                  << " [--seed S] [--id K] [--threads T] [--binary] [--min A] [--max B] [-o PATH]" << std::endl;
+        return 1;
+    }
+
+    GeneratorConfig config;
+    std::string kind = argv[1];
+    if (kind == "uniform")
+    {
+        config.distribution = Distribution::Uniform;
+    }
+    else if (kind == "triplet")
+    {
+        config.distribution = Distribution::Triplet;
+    }
+    else if (kind == "falkenauer_u")
+    {
+        config.distribution = Distribution::FalkenauerU;
+    }
+    else
+    {
+        std::cerr << "Unknown distribution: " << kind << std::endl;
+        return 1;
+    }
+
+    config.n = std::stoull(argv[2]);
+    config.dim = static_cast<uint32_t>(std::stoul(argv[3]));
+    config.capacities = parseCapacities(argv[4]);
+    if (config.dim == 0 || config.capacities.empty())
+    {
+        std::cerr << "Invalid dimension or capacities" << std::endl;
+        return 1;
+    }
+    // A single capacity applies to every dimension.
+    if (config.capacities.size() == 1)
+    {
+        config.capacities.resize(config.dim, config.capacities[0]);
+    }
+    if (config.capacities.size() != config.dim)
+    {
+        std::cerr << "Expected " << config.dim << " capacities, got " << config.capacities.size() << std::endl;
+        return 1;
+    }
+    // Uniform sizes are drawn from 1 .. capacity, so every capacity must be at least 1.
+    if (std::find(config.capacities.begin(), config.capacities.end(), 0u) != config.capacities.end())
+    {
+        std::cerr << "Capacities must be positive" << std::endl;
+        return 1;
+    }
+
+    for (int i = 5; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--binary")
+        {
+            config.binary = true;
+        }
+        else if (arg == "--seed" && hasValue)
+        {
+            config.seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--id" && hasValue)
+        {
+            config.id = std::stoi(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            config.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--min" && hasValue)
+        {
+            config.minSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--max" && hasValue)
+        {
+            config.maxSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "-o" && hasValue)
+        {
+            config.output = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (config.minSize > config.maxSize)
+    {
+        std::cerr << "Invalid size range " << config.minSize << ".." << config.maxSize << std::endl;
+        return 1;
+    }
+    if (config.distribution == Distribution::Triplet && config.n % 3 != 0)
+    {
+        config.n -= config.n % 3;
+        std::cerr << "Triplet instances need a multiple of 3 items, generating " << config.n << std::endl;
+    }
+
+    if (config.output.empty())
+    {
+        config.output = defaultOutputPath(config);
+    }
+
+    InstanceGenerator generator(config);
+    bool ok;
+    if (config.output == "-")
+    {
+        std::ios::sync_with_stdio(false);
+        ok = generator.write(std::cout);
+    }
+    else
+    {
+        std::ofstream file(config.output, std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "Cannot open " << config.output << std::endl;
+            return 1;
+        }
+        ok = generator.write(file);
+    }
+
+    if (!ok)
+    {
+        std::cerr << "Failed to write " << config.output << std::endl;
+        return 1;
+    }
+    return 0;
+}
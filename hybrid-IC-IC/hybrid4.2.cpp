@@ -1,6 +1,8 @@
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
+#include <utility>
 #include <chrono>
 
 // ---------------FFD -> BFD-------------------
@@ -31,13 +33,14 @@ private:
 class BinPacking
 {
 public:
-    BinPacking(int bin_capacity) : bin_capacity_(bin_capacity) {}
+    BinPacking(int bin_capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bin_capacity_(bin_capacity), bins_(resource) {}
     void addItem(const Item& item);
     int getNumBins() const { return bins_.size(); }
 
 private:
     int bin_capacity_;
-public:std::vector<Bin> bins_;
+public:std::pmr::vector<Bin> bins_;
 };
 
 void BinPacking::addItem(const Item& item)
@@ -65,13 +68,14 @@ void BinPacking::addItem(const Item& item)
 class BinPackingBFD
 {
 public:
-    BinPackingBFD(int bin_capacity) : bin_capacity_(bin_capacity) {}
+    BinPackingBFD(int bin_capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bin_capacity_(bin_capacity), bins_(resource) {}
     void addItem(const Item& item);
     int getNumBins() const { return bins_.size(); }
 
 private:
     int bin_capacity_;
-public:std::vector<Bin> bins_;
+public:std::pmr::vector<Bin> bins_;
 };
 
 void BinPackingBFD::addItem(const Item& item)
@@ -95,22 +99,26 @@ void BinPackingBFD::addItem(const Item& item)
 class HybridBinPacking
 {
 public:
-    HybridBinPacking(int bin_capacity, int threshold) : bin_capacity_(bin_capacity), threshold_(threshold) {}
+    HybridBinPacking(int bin_capacity, int threshold, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bin_capacity_(bin_capacity), threshold_(threshold), resource_(resource), bins_(resource) {}
     bool runHybridAlgorithm(const std::vector<int>& item_sizes);
     int getNumBins() const { return bins_.size(); }
 
 private:
     int bin_capacity_;
     int threshold_;
-    std::vector<Bin> bins_;
+    std::pmr::memory_resource* resource_;
+    std::pmr::vector<Bin> bins_;
 };
 
 bool HybridBinPacking::runHybridAlgorithm(const std::vector<int>& item_sizes)
 {
+    // The engines allocate from resource_, so the one that succeeds hands its bins over by move.
+
     auto start_time = std::chrono::high_resolution_clock::now();
     // Phase 1 - Run FFDwith reduced bin capacity
     int reduced_capacity = bin_capacity_ - threshold_;
-    BinPacking packing(reduced_capacity);
+    BinPacking packing(reduced_capacity, resource_);
 
     for (int size : item_sizes)
     {
@@ -121,7 +129,7 @@ bool HybridBinPacking::runHybridAlgorithm(const std::vector<int>& item_sizes)
     int used_bins = packing.getNumBins();
     if (used_bins == 0) {
         // Phase 2 - Run BFD with original bin capacity
-        BinPackingBFD bfd(bin_capacity_);
+        BinPackingBFD bfd(bin_capacity_, resource_);
         for (int size : item_sizes)
         {
             Item item(size);
@@ -131,7 +139,7 @@ bool HybridBinPacking::runHybridAlgorithm(const std::vector<int>& item_sizes)
         if (bfd.getNumBins() > 0)
         {
             std::cout << "BFD successful." << std::endl;
-            bins_ = bfd.bins_;
+            bins_ = std::move(bfd.bins_);
             auto end_time = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
@@ -143,7 +151,7 @@ bool HybridBinPacking::runHybridAlgorithm(const std::vector<int>& item_sizes)
     else 
     {
         std::cout << "BFD with reduced capacity successful." << std::endl;
-        bins_ = packing.bins_;
+        bins_ = std::move(packing.bins_);
         auto end_time = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
+#include <utility>
 #include <chrono>
 
 // ---------------FFD -> BFD-------------------
@@ -31,13 +33,14 @@ private:
 class BinPacking
 {
 public:
-    BinPacking(int bin_capacity) : bin_capacity_(bin_capacity) {}
+    BinPacking(int bin_capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bin_capacity_(bin_capacity), bins_(resource) {}
     void addItem(const Item& item);
     int getNumBins() const { return bins_.size(); }
 
 private:
     int bin_capacity_;
-public:std::vector<Bin> bins_;
+public:std::pmr::vector<Bin> bins_;
 };
 
 void BinPacking::addItem(const Item& item)
@@ -65,13 +68,14 @@ void BinPacking::addItem(const Item& item)
 class BinPackingBFD
 {
 public:
-    BinPackingBFD(int bin_capacity) : bin_capacity_(bin_capacity) {}
+    BinPackingBFD(int bin_capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bin_capacity_(bin_capacity), bins_(resource) {}
     void addItem(const Item& item);
     int getNumBins() const { return bins_.size(); }
 
 private:
     int bin_capacity_;
-public:std::vector<Bin> bins_;
+public:std::pmr::vector<Bin> bins_;
 };
 
 void BinPackingBFD::addItem(const Item& item)
@@ -95,18 +99,22 @@ void BinPackingBFD::addItem(const Item& item)
 class HybridBinPacking
 {
 public:
-    HybridBinPacking(int bin_capacity, int threshold) : bin_capacity_(bin_capacity), threshold_(threshold) {}
+    HybridBinPacking(int bin_capacity, int threshold, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bin_capacity_(bin_capacity), threshold_(threshold), resource_(resource), bins_(resource) {}
     bool runHybridAlgorithm(const std::vector<int>& item_sizes);
     int getNumBins() const { return bins_.size(); }
 
 private:
     int bin_capacity_;
     int threshold_;
-    std::vector<Bin> bins_;
+    std::pmr::memory_resource* resource_;
+    std::pmr::vector<Bin> bins_;
 };
 
 bool HybridBinPacking::runHybridAlgorithm(const std::vector<int>& item_sizes)
 {
+    // The engines allocate from resource_, so the one that succeeds hands its bins over by move.
+
     // Phase 1 - Run FFD or BFD with m bins
 
     auto start_time = std::chrono::high_resolution_clock::now();  //start the measure
@@ -116,7 +124,7 @@ bool HybridBinPacking::runHybridAlgorithm(const std::vector<int>& item_sizes)
     //Using counterr to keep trackk of the items stacked
     int numItemsStacked = 0;
 
-    BinPacking packing(bin_capacity_);
+    BinPacking packing(bin_capacity_, resource_);
 
     // Ensure there are m bins available in the packing
     for (int i = 0; i < numBins; ++i)
@@ -138,7 +146,7 @@ bool HybridBinPacking::runHybridAlgorithm(const std::vector<int>& item_sizes)
         if (packing.getNumBins() > 0)
         {
             std::cout << "FFD with " << numBins << " bins successful." << std::endl;
-            bins_ = packing.bins_;
+            bins_ = std::move(packing.bins_);
             auto end_time = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
@@ -149,7 +157,7 @@ bool HybridBinPacking::runHybridAlgorithm(const std::vector<int>& item_sizes)
     }
 
     // Phase 2 - Run BFD to place left-over items in the activated containers.
-    BinPackingBFD bfd(bin_capacity_);
+    BinPackingBFD bfd(bin_capacity_, resource_);
 
     for (const Bin& bin : packing.bins_)
     {
@@ -160,7 +168,7 @@ bool HybridBinPacking::runHybridAlgorithm(const std::vector<int>& item_sizes)
     if (bfd.getNumBins() > 0)
     {
         std::cout << "BFD for left-over items successful." << std::endl;
-        bins_ = bfd.bins_;
+        bins_ = std::move(bfd.bins_);
         auto end_time = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
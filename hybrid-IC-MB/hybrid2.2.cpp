@@ -1,11 +1,21 @@
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
+#include <utility>
 #include <cmath>
 #include <chrono>
+#include <string>
+#include <numeric>
+#include <fstream>
+
+#include "../binContents.h"
+#include "../solutionWriter.h"
 
 //-------------------IC-BFD -> MB-FFD----------------
 
+SolutionWriter solutionOut;
+
 class Item
 {
 public:
@@ -19,7 +29,7 @@ private:
 class Bin
 {
 public:
-    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity) {}
+    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity), count_(0) {}
     bool canFit(const Item& item) const { return remaining_capacity_ >= item.getSize(); }
     bool addItem(const Item& item) {
         if (!canFit(item))
@@ -27,35 +37,37 @@ public:
             return false;
         }
         remaining_capacity_ -= item.getSize();
-        items.push_back(item);
+        ++count_;
         return true;
     }
     bool isFull() const { return remaining_capacity_ == 0; }
     int getRemainingCapacity() const { return remaining_capacity_; }
-    const std::vector<Item>& getItems() const { return items; }
+    int getNumItems() const { return count_; }
 
 private:
     int capacity_;
     int remaining_capacity_;
-    std::vector<Item> items;
+    int count_;
 };
 
-bool packItemsIC(const std::vector<Item>& items, std::vector<Bin>& bins, int binCapacity)
+bool packItemsIC(const std::pmr::vector<Item>& items, std::pmr::vector<Bin>& bins, BinContents& contents, int binCapacity)
 {
-    // Sort items in decreasing order
-    std::vector<Item> sortedItems = items;
-    std::sort(sortedItems.begin(), sortedItems.end(), [](const Item& a, const Item& b)
+    // Sort the item ids in decreasing order of size
+    std::pmr::vector<int> order(items.size(), 0, bins.get_allocator());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b)
         {
-            return a.getSize() > b.getSize();
+            return items[a].getSize() > items[b].getSize();
         });
 
-    for (const auto& item : sortedItems)
+    for (int id : order)
     {
+        const Item& item = items[id];
         // Best Fit logic for IC-BFD: Find the bin with the smallest remaining capacity
         int bestBinIdx = -1;
         int smallestRemainingCapacity = binCapacity + 1; // Initialize to a value greater than the bin capacity
 
-        for (int i = 0; i < bins.size(); ++i)
+        for (int i = 0; i < static_cast<int>(bins.size()); ++i)
         {
             if (bins[i].canFit(item) && bins[i].getRemainingCapacity() < smallestRemainingCapacity)
             {
@@ -68,12 +80,16 @@ bool packItemsIC(const std::vector<Item>& items, std::vector<Bin>& bins, int bin
         {
             // Item fits in an existing bin with the best fit, so add it to that bin
             bins[bestBinIdx].addItem(item);
+            contents.add(id, bestBinIdx);
         }
         else
         {
             // Item couldn't fit in any existing bin, so create a new bin and add it
             Bin newBin(binCapacity);
-            newBin.addItem(item);
+            if (newBin.addItem(item))
+            {
+                contents.add(id, static_cast<int>(bins.size()));
+            }
             bins.push_back(newBin);
         }
     }
@@ -81,29 +97,31 @@ bool packItemsIC(const std::vector<Item>& items, std::vector<Bin>& bins, int bin
     return true;
 }
 
-bool packItemsICWithReducedCapacity(const std::vector<Item>& items, std::vector<Bin>& bins, int binCapacity)
+bool packItemsICWithReducedCapacity(const std::pmr::vector<Item>& items, std::pmr::vector<Bin>& bins, BinContents& contents, int binCapacity)
 {
     // Threshold-based approach: Decrease bin capacity before running IC-BFD algorithm
     int reducedBinCapacity = binCapacity / 2; // Example: Set reduced capacity to half of the original capacity
     // Now, run IC-BFD with reduced capacity
-    return packItemsIC(items, bins, reducedBinCapacity);
+    return packItemsIC(items, bins, contents, reducedBinCapacity);
 }
 
-bool packItemsIntoBins(std::vector<Item>& items, std::vector<Bin>& bins, int binCapacity)
+// Places the items whose ids are in order, sorting the ids in decreasing order of size first.
+bool packItemsIntoBins(const std::pmr::vector<Item>& items, std::pmr::vector<int>& order, std::pmr::vector<Bin>& bins, BinContents& contents, int binCapacity)
 {
-    // Sort items in decreasing order
-    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b)
+    std::sort(order.begin(), order.end(), [&](int a, int b)
         {
-            return a.getSize() > b.getSize();
+            return items[a].getSize() > items[b].getSize();
         });
 
-    for (const auto& item : items)
+    for (int id : order)
     {
+        const Item& item = items[id];
         bool itemPacked = false;
-        for (auto& bin : bins)
+        for (int i = 0; i < static_cast<int>(bins.size()); ++i)
         {
-            if (!bin.isFull() && bin.addItem(item))
+            if (!bins[i].isFull() && bins[i].addItem(item))
             {
+                contents.add(id, i);
                 itemPacked = true;
                 break;
             }
@@ -119,17 +137,25 @@ bool packItemsIntoBins(std::vector<Item>& items, std::vector<Bin>& bins, int bin
 class HybridBinPacking
 {
 public:
-    HybridBinPacking(int maxBins, int batchIncrement, int binCapacity)
-        : maxBins_(maxBins), batchIncrement_(batchIncrement), binCapacity_(binCapacity) {}
+    HybridBinPacking(int maxBins, int batchIncrement, int binCapacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : maxBins_(maxBins), batchIncrement_(batchIncrement), binCapacity_(binCapacity), resource_(resource), items(resource), contents_(resource) {}
 
     void addItem(const Item& item);
     bool runHybridAlgorithm();
 
+    // Writes the packing of the last successful run, see BinContents::writeAssignment.
+    bool writeAssignment(const std::string& path) const
+    {
+        return contents_.writeAssignment(path, items.size());
+    }
+
 private:
     int maxBins_;
     int batchIncrement_;
     int binCapacity_;
-    std::vector<Item> items;
+    std::pmr::memory_resource* resource_;
+    std::pmr::vector<Item> items;
+    BinContents contents_;
 };
 
 void HybridBinPacking::addItem(const Item& item)
@@ -137,9 +163,9 @@ void HybridBinPacking::addItem(const Item& item)
     items.push_back(item);
 }
 
-int calculateLowerBound(const std::vector<Item>& items, int binCapacity)
+int calculateLowerBound(const std::pmr::vector<Item>& items, int binCapacity)
 {
-    int sumItemSizes = 0;
+    long long sumItemSizes = 0;
     for (const auto& item : items)
     {
         sumItemSizes += item.getSize();
@@ -149,14 +175,18 @@ int calculateLowerBound(const std::vector<Item>& items, int binCapacity)
 
 bool HybridBinPacking::runHybridAlgorithm()
 {
+    std::pmr::monotonic_buffer_resource arena(resource_);
+
     auto start_time = std::chrono::high_resolution_clock::now(); //start the measur
 
     int lowerBound = calculateLowerBound(items, binCapacity_);
     int m = std::min(maxBins_, lowerBound);
 
     // Stage 1: IC-BFD Algorithm with reduced capacity
-    std::vector<Bin> binsIC(m, Bin(binCapacity_));
-    bool successIC = packItemsICWithReducedCapacity(items, binsIC, binCapacity_);
+    std::pmr::vector<Bin> binsIC(m, Bin(binCapacity_), &arena);
+    // The contents come from resource_, so the stage that succeeds hands them over by move.
+    BinContents contentsIC(resource_);
+    bool successIC = packItemsICWithReducedCapacity(items, binsIC, contentsIC, binCapacity_);
 
     if (successIC)
     {
@@ -166,49 +196,125 @@ bool HybridBinPacking::runHybridAlgorithm()
         {
             bin = Bin(binCapacity_); // Restore capacity to normal for each bin
         }
+        contentsIC.clear();
 
         // Proceed to MB-FFD with restored bin capacities
-        bool successMB = packItemsIntoBins(items, binsIC, binCapacity_);
+        std::pmr::vector<int> order(items.size(), 0, &arena);
+        std::iota(order.begin(), order.end(), 0);
+        bool successMB = packItemsIntoBins(items, order, binsIC, contentsIC, binCapacity_);
 
         if (successMB)
         {
             // MB-FFD succeeded
-            std::cout << "Successfully packed items into bins using the MB-FFD algorithm!" << std::endl;
-            for (int i = 0; i < binsIC.size(); i++)
+            solutionOut << "Successfully packed items into bins using the MB-FFD algorithm!" << '\n';
+            contentsIC.build(static_cast<int>(binsIC.size()));
+            auto end_time = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+            contents_ = std::move(contentsIC);
+            for (int i = 0; !solutionOut.isQuiet() && i < static_cast<int>(binsIC.size()); i++)
             {
-                std::cout << "Bin " << i + 1 << ": ";
-                for (const auto& item : binsIC[i].getItems())
+                solutionOut << "Bin " << i + 1 << ": ";
+                for (int id : contents_.getItems(i))
                 {
-                    std::cout << "Item (Size: " << item.getSize() << ") ";
+                    const Item& item = items[id];
+                    solutionOut << "Item (Size: " << item.getSize() << ") ";
                 }
-                std::cout << std::endl;
+                solutionOut << '\n';
             }
-            auto end_time = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
-            std::cout << "Execution time for MB-FFD: " << duration.count() << " microseconds" << std::endl;
+            solutionOut << "Execution time for MB-FFD: " << duration.count() << " microseconds" << '\n';
             return true;
         }
     }
     return false;
 }
 
-int main()
+// Reads a Falkenauer instance: the item count, the bin capacity, then one size per line.
+bool readInstance(const std::string& path, int& binCapacity, std::vector<int>& sizes)
+{
+    std::ifstream file(path);
+    size_t count = 0;
+    if (!(file >> count >> binCapacity) || binCapacity <= 0)
+    {
+        return false;
+    }
+    sizes.resize(count);
+    for (int& size : sizes)
+    {
+        if (!(file >> size) || size <= 0 || size > binCapacity)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
 {
+    // --quiet skips the bin listings. --instance reads a Falkenauer instance (item count,
+    // capacity, one size per line) in place of the built-in items, --assignment writes the
+    // bin of every item in the format largeInstance reads through --initial.
+    std::string instancePath;
+    std::string assignmentPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--quiet")
+        {
+            solutionOut.setQuiet(true);
+        }
+        else if (arg == "--instance" && i + 1 < argc)
+        {
+            instancePath = argv[++i];
+        }
+        else if (arg == "--assignment" && i + 1 < argc)
+        {
+            assignmentPath = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
     int maxBins = 3;
     int batchIncrement = 1;
     int binCapacity = 100;
+    std::vector<int> sizes;
+    if (!instancePath.empty())
+    {
+        if (!readInstance(instancePath, binCapacity, sizes))
+        {
+            std::cerr << "Cannot read the instance " << instancePath << std::endl;
+            return 1;
+        }
+        // Enough bins for every item to get one of its own
+        maxBins = std::max(maxBins, static_cast<int>(sizes.size()));
+    }
 
     HybridBinPacking hybridBinPacking(maxBins, batchIncrement, binCapacity);
 
-    hybridBinPacking.addItem(Item(10));
-    hybridBinPacking.addItem(Item(21));
-    hybridBinPacking.addItem(Item(44));
+    if (instancePath.empty())
+    {
+        hybridBinPacking.addItem(Item(10));
+        hybridBinPacking.addItem(Item(21));
+        hybridBinPacking.addItem(Item(44));
+    }
+    for (int size : sizes)
+    {
+        hybridBinPacking.addItem(Item(size));
+    }
 
     bool success = hybridBinPacking.runHybridAlgorithm();
 
     if (!success) {
-        std::cout << "Both IC-BFD and MB-FFD algorithms have failed. No feasible solution found." << std::endl;
+        solutionOut << "Both IC-BFD and MB-FFD algorithms have failed. No feasible solution found." << '\n';
+    }
+
+    if (!assignmentPath.empty() && !hybridBinPacking.writeAssignment(assignmentPath))
+    {
+        std::cerr << "No complete packing to write to " << assignmentPath << std::endl;
+        return 1;
     }
 
     return 0;
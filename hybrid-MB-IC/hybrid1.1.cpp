@@ -1,10 +1,20 @@
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
+#include <utility>
 #include <chrono>
+#include <string>
+#include <numeric>
+#include <fstream>
+
+#include "../binContents.h"
+#include "../solutionWriter.h"
 
 //------------------MB-BFD -> FFD-------------
 
+SolutionWriter solutionOut;
+
 class Item
 {
 public:
@@ -18,44 +28,47 @@ private:
 class Bin
 {
 public:
-    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity) {}
+    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity), count_(0) {}
     bool canFit(const Item& item) const { return remaining_capacity_ >= item.getSize(); }
-    void addItem(const Item& item) { remaining_capacity_ -= item.getSize(); items.push_back(item); }
+    void addItem(const Item& item) { remaining_capacity_ -= item.getSize(); ++count_; }
     int getRemainingCapacity() const { return remaining_capacity_; }
-    const std::vector<Item>& getItems() const { return items; }
+    int getNumItems() const { return count_; }
 
 private:
     int capacity_;
     int remaining_capacity_;
-    std::vector<Item> items;
+    int count_;
 };
 
 class Multibin
 {
 public:
-    Multibin(int maxBins, int binCapacity) : maxBins_(maxBins), binCapacity_(binCapacity) {}
+    Multibin(int maxBins, int binCapacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : maxBins_(maxBins), binCapacity_(binCapacity), items(resource), bins(resource), contents(resource) {}
 
     void addItem(const Item& item);
     bool packItems();
 
     void printBins() const
     {
-        for (int i = 0; i < bins.size(); i++)
+        for (int i = 0; !solutionOut.isQuiet() && i < static_cast<int>(bins.size()); i++)
         {
-            std::cout << "Bin " << i + 1 << ": ";
-            for (const auto& item : bins[i].getItems())
+            solutionOut << "Bin " << i + 1 << ": ";
+            for (int id : contents.getItems(i))
             {
-                std::cout << "Item (Size: " << item.getSize() << ") ";
+                const Item& item = items[id];
+                solutionOut << "Item (Size: " << item.getSize() << ") ";
             }
-            std::cout << std::endl;
+            solutionOut << '\n';
         }
     }
 
 private:
     int maxBins_;
     int binCapacity_;
-    std::vector<Item> items;
-public: std::vector<Bin> bins;
+    std::pmr::vector<Item> items;
+public: std::pmr::vector<Bin> bins;
+    BinContents contents;
 };
 
 void Multibin::addItem(const Item& item)
@@ -65,21 +78,25 @@ void Multibin::addItem(const Item& item)
 
 bool Multibin::packItems()
 {
-    // Sort items in decreasing order
-    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
-        return a.getSize() > b.getSize();
+    // Sort the item ids in decreasing order of size
+    std::pmr::vector<int> order(items.size(), 0, items.get_allocator());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return items[a].getSize() > items[b].getSize();
         });
 
     // Initialize m bins
     bins.resize(maxBins_, Bin(binCapacity_));
 
-    for (const auto& item : items) {
+    for (int id : order) {
+        const Item& item = items[id];
         bool itemPacked = false;
-        for (int i = 0; i < bins.size(); ++i)
+        for (int i = 0; i < static_cast<int>(bins.size()); ++i)
         {
             if (bins[i].canFit(item))
             {
                 bins[i].addItem(item);
+                contents.add(id, i);
                 itemPacked = true;
 
                 break;
@@ -92,26 +109,32 @@ bool Multibin::packItems()
         }
     }
 
-    // Display the packed bins
-    std::cout << "Successfully packed items into bins using the MB-BFD algorithm!" << std::endl;
-    printBins();
+    contents.build(static_cast<int>(bins.size()));
     return true;
 }
 
 class HybridBinPacking
 {
 public:
-    HybridBinPacking(int maxBins, int batchIncrement, int binCapacity)
-        : maxBins_(maxBins), batchIncrement_(batchIncrement), binCapacity_(binCapacity) {}
+    HybridBinPacking(int maxBins, int batchIncrement, int binCapacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : maxBins_(maxBins), batchIncrement_(batchIncrement), binCapacity_(binCapacity), resource_(resource), items(resource), contents_(resource) {}
 
     void addItem(const Item& item);
     bool runHybridAlgorithm();
 
+    // Writes the packing of the last successful run, see BinContents::writeAssignment.
+    bool writeAssignment(const std::string& path) const
+    {
+        return contents_.writeAssignment(path, items.size());
+    }
+
 private:
     int maxBins_;
     int batchIncrement_;
     int binCapacity_;
-    std::vector<Item> items;
+    std::pmr::memory_resource* resource_;
+    std::pmr::vector<Item> items;
+    BinContents contents_;
 };
 
 void HybridBinPacking::addItem(const Item& item)
@@ -121,17 +144,19 @@ void HybridBinPacking::addItem(const Item& item)
 
 bool HybridBinPacking::runHybridAlgorithm()
 {
+    // The engines allocate from resource_, so the one that succeeds hands its contents over by move.
+
     auto start_time = std::chrono::high_resolution_clock::now();
-    int lowerBound = 0;
+    long long lowerBound = 0;
     for (const auto& item : items)
     {
         lowerBound += item.getSize();
     }
 
-    int m = std::min(maxBins_, lowerBound);
+    int m = static_cast<int>(std::min(static_cast<long long>(maxBins_), lowerBound));
 
     // MB-BFD algorithm
-    Multibin multibin(m, binCapacity_);
+    Multibin multibin(m, binCapacity_, resource_);
     for (const auto& item : items)
     {
         multibin.addItem(item);
@@ -145,39 +170,37 @@ bool HybridBinPacking::runHybridAlgorithm()
         auto end_time = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
-        std::cout << "Execution time of MB-BFD: " << duration.count() << " microseconds" << std::endl;
+        solutionOut << "Successfully packed items into bins using the MB-BFD algorithm!" << '\n';
+        multibin.printBins();
+        contents_ = std::move(multibin.contents);
+        solutionOut << "Execution time of MB-BFD: " << duration.count() << " microseconds" << '\n';
         return true;
     }
 
     else
     {
-        std::cout << "\nMB-BFD FAILED TO PACK ALL ITEMS !\n";
+        solutionOut << "\nMB-BFD FAILED TO PACK ALL ITEMS !\n";
          auto end_time = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
-        std::cout << "\nExecution time of MB-BFD: " << duration.count() << " microseconds" << std::endl;
+        solutionOut << "\nExecution time of MB-BFD: " << duration.count() << " microseconds" << '\n';
     }
 
-    auto start_time = std::chrono::high_resolution_clock::now();
+    start_time = std::chrono::high_resolution_clock::now();
     // FFD algorithm (continue from the state where MB-BFD left off)
-    std::vector<Bin>& bins = multibin.bins;
+    std::pmr::vector<Bin>& bins = multibin.bins;
 
     // Items that were not packed by MB-BFD
-    std::vector<Item> remainingItems;
-    for (int i = m; i < items.size(); ++i)
-    {
-        remainingItems.push_back(items[i]);
-    }
-
-
-    for (const auto& item : remainingItems)
+    for (int id = m; id < static_cast<int>(items.size()); ++id)
     {
+        const Item& item = items[id];
         bool itemPacked = false;
-        for (int i = 0; i < bins.size(); ++i)
+        for (int i = 0; i < static_cast<int>(bins.size()); ++i)
         {
             if (bins[i].canFit(item))
             {
                 bins[i].addItem(item);
+                multibin.contents.add(id, i);
                 itemPacked = true;
                 break;
             }
@@ -188,47 +211,110 @@ bool HybridBinPacking::runHybridAlgorithm()
             Bin newBin(binCapacity_);
             newBin.addItem(item);
             bins.push_back(newBin);
+            multibin.contents.add(id, static_cast<int>(bins.size()) - 1);
         }
     }
 
+    multibin.contents.build(static_cast<int>(bins.size()));
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
     // Display the packed bins using FFD
-    std::cout << "Successfully packed items into bins using the FFD algorithm!" << std::endl;
-    int binNumber = 1;
-    for (const auto& bin : bins)
+    solutionOut << "Successfully packed items into bins using the FFD algorithm!" << '\n';
+    multibin.printBins();
+    contents_ = std::move(multibin.contents);
+    solutionOut << "\nExecution time of FFD: " << duration.count() << " microseconds" << '\n';
+
+    return true;
+}
+
+// Reads a Falkenauer instance: the item count, the bin capacity, then one size per line.
+bool readInstance(const std::string& path, int& binCapacity, std::vector<int>& sizes)
+{
+    std::ifstream file(path);
+    size_t count = 0;
+    if (!(file >> count >> binCapacity) || binCapacity <= 0)
+    {
+        return false;
+    }
+    sizes.resize(count);
+    for (int& size : sizes)
     {
-        std::cout << "Bin " << binNumber << ": ";
-        for (const auto& item : bin.getItems())
+        if (!(file >> size) || size <= 0 || size > binCapacity)
         {
-            std::cout << "Item (Size: " << item.getSize() << ") ";
+            return false;
         }
-        std::cout << std::endl;
-        binNumber++;
     }
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-
-    std::cout << "\nExecution time of FFD: " << duration.count() << " microseconds" << std::endl;
-
     return true;
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    // --quiet skips the bin listings. --instance reads a Falkenauer instance (item count,
+    // capacity, one size per line) in place of the built-in items, --assignment writes the
+    // bin of every item in the format largeInstance reads through --initial.
+    std::string instancePath;
+    std::string assignmentPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--quiet")
+        {
+            solutionOut.setQuiet(true);
+        }
+        else if (arg == "--instance" && i + 1 < argc)
+        {
+            instancePath = argv[++i];
+        }
+        else if (arg == "--assignment" && i + 1 < argc)
+        {
+            assignmentPath = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
 
     int maxBins = 3;
     int batchIncrement = 1;
     int binCapacity = 100;
+    std::vector<int> sizes;
+    if (!instancePath.empty())
+    {
+        if (!readInstance(instancePath, binCapacity, sizes))
+        {
+            std::cerr << "Cannot read the instance " << instancePath << std::endl;
+            return 1;
+        }
+        // Enough bins for every item to get one of its own
+        maxBins = std::max(maxBins, static_cast<int>(sizes.size()));
+    }
 
     HybridBinPacking hybridBinPacking(maxBins, batchIncrement, binCapacity);
 
-    hybridBinPacking.addItem(Item(30));
-    hybridBinPacking.addItem(Item(40));
-    hybridBinPacking.addItem(Item(60));
-    hybridBinPacking.addItem(Item(70));
-    hybridBinPacking.addItem(Item(10));
-    hybridBinPacking.addItem(Item(80));
+    if (instancePath.empty())
+    {
+        hybridBinPacking.addItem(Item(30));
+        hybridBinPacking.addItem(Item(40));
+        hybridBinPacking.addItem(Item(60));
+        hybridBinPacking.addItem(Item(70));
+        hybridBinPacking.addItem(Item(10));
+        hybridBinPacking.addItem(Item(80));
+    }
+    for (int size : sizes)
+    {
+        hybridBinPacking.addItem(Item(size));
+    }
 
     hybridBinPacking.runHybridAlgorithm();
 
+    if (!assignmentPath.empty() && !hybridBinPacking.writeAssignment(assignmentPath))
+    {
+        std::cerr << "No complete packing to write to " << assignmentPath << std::endl;
+        return 1;
+    }
+
     return 0;
 }
@@ -1,9 +1,18 @@
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
+#include <utility>
 #include <cmath>
 #include <numeric>
 #include <chrono>
+#include <string>
+#include <fstream>
+
+#include "../binContents.h"
+#include "../solutionWriter.h"
+
+SolutionWriter solutionOut;
 
 class Item
 {
@@ -20,7 +29,7 @@ private:
 class Bin
 {
 public:
-    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity) {}
+    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity), count_(0) {}
     bool canFit(const Item& item) const { return remaining_capacity_ >= item.getSize(); }
     bool addItem(const Item& item)
     {
@@ -29,61 +38,76 @@ public:
             return false;
         }
         remaining_capacity_ -= item.getSize();
-        items.push_back(item);
+        ++count_;
         return true;
     }
     bool isFull() const { return remaining_capacity_ == 0; }
     int getRemainingCapacity() const { return remaining_capacity_; }
-    const std::vector<Item>& getItems() const { return items; }
+    int getNumItems() const { return count_; }
 
 private:
     int capacity_;
     int remaining_capacity_;
-    std::vector<Item> items;
+    int count_;
 };
 
 class MBBinPacking
 {
 public:
-    MBBinPacking(int binCapacity) : binCapacity_(binCapacity) {}
+    MBBinPacking(int binCapacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : binCapacity_(binCapacity), bins_(resource), contents_(resource) {}
     void addItem(const Item& item);
     int getNumBins() const { return bins_.size(); }
-    const std::vector<Bin>& getBins() const { return bins_; }
+    const std::pmr::vector<Bin>& getBins() const { return bins_; }
+    const BinContents& getContents() const { return contents_; }
+    BinContents takeContents() { return std::move(contents_); }
+    void buildContents() { contents_.build(getNumBins()); }
 
 private:
     int binCapacity_;
-    std::vector<Bin> bins_;
+    std::pmr::vector<Bin> bins_;
+    BinContents contents_;
+    int numItems_ = 0;
 };
 
+// Items are numbered in the order they are added, the contents hold these ids.
 void MBBinPacking::addItem(const Item& item)
 {
+    int id = numItems_++;
     auto it = std::min_element(bins_.begin(), bins_.end(), [&](const Bin& bin1, const Bin& bin2) {
         return bin1.getRemainingCapacity() < bin2.getRemainingCapacity() && bin1.canFit(item);
         });
 
     if (it != bins_.end()) {
-        it->addItem(item);
+        if (it->addItem(item)) {
+            contents_.add(id, static_cast<int>(it - bins_.begin()));
+        }
     }
     else {
         Bin new_bin(binCapacity_);
-        new_bin.addItem(item);
+        if (new_bin.addItem(item)) {
+            contents_.add(id, getNumBins());
+        }
         bins_.push_back(new_bin);
     }
 }
 
-bool packItemsIntoBins(std::vector<Item>& items, std::vector<Bin>& bins, int binCapacity)
+bool packItemsIntoBins(const std::pmr::vector<Item>& items, std::pmr::vector<Bin>& bins, BinContents& contents, int binCapacity)
 {
-    sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
-        return a.getSize() > b.getSize(); // Sort items in descending order
+    std::pmr::vector<int> order(items.size(), 0, bins.get_allocator());
+    std::iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        return items[a].getSize() > items[b].getSize(); // Sort item ids in descending order of size
         });
 
-    for (const auto& item : items)
+    for (int id : order)
     {
+        const Item& item = items[id];
         bool itemPacked = false;
         int bestFitBinIdx = -1;
         int minRemainingSpace = binCapacity + 1;
 
-        for (int i = 0; i < bins.size(); ++i)
+        for (int i = 0; i < static_cast<int>(bins.size()); ++i)
         {
             int remainingSpace = bins[i].getRemainingCapacity();
             if (remainingSpace >= item.getSize() && remainingSpace < minRemainingSpace)
@@ -96,6 +120,7 @@ bool packItemsIntoBins(std::vector<Item>& items, std::vector<Bin>& bins, int bin
         if (bestFitBinIdx != -1)
         {
             bins[bestFitBinIdx].addItem(item);
+            contents.add(id, bestFitBinIdx);
             itemPacked = true;
         }
 
@@ -110,25 +135,34 @@ bool packItemsIntoBins(std::vector<Item>& items, std::vector<Bin>& bins, int bin
 class Multibin
 {
 public:
-    Multibin(int maxBins, int incrementStrategy, int threshold)
-        : maxBins_(maxBins), incrementStrategy_(incrementStrategy), threshold_(threshold) {}
+    Multibin(int maxBins, int incrementStrategy, int threshold, int binCapacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : maxBins_(maxBins), incrementStrategy_(incrementStrategy), threshold_(threshold), binCapacity_(binCapacity), resource_(resource), items_(resource), bins_(resource), contents_(resource) {}
 
     void addItem(const Item& item)
     {
         items_.push_back(item);
     }
 
+    const BinContents& getContents() const { return contents_; }
+    BinContents takeContents() { return std::move(contents_); }
+
     bool packItems()
     {
+        // Allocated like bins_ and contents_, so the attempt that succeeds is moved in.
+        std::pmr::vector<Bin> activeBins(resource_);
+        BinContents activeContents(resource_);
         int n = 1;
         while (n <= maxBins_)
         {
             int currentBinCapacity = (n <= threshold_) ? n : binCapacity_;
-            std::vector<Bin> activeBins(n, Bin(currentBinCapacity));
-            bool success = packItemsIntoBins(items_, activeBins, currentBinCapacity);
+            activeBins.assign(n, Bin(currentBinCapacity));
+            activeContents.clear();
+            bool success = packItemsIntoBins(items_, activeBins, activeContents, currentBinCapacity);
             if (success)
             {
-                bins_ = activeBins;
+                bins_ = std::move(activeBins);
+                contents_ = std::move(activeContents);
+                contents_.build(n);
                 return true;
             }
 
@@ -147,14 +181,15 @@ public:
 
     void printBins() const
     {
-        for (int i = 0; i < bins_.size(); i++)
+        for (int i = 0; !solutionOut.isQuiet() && i < static_cast<int>(bins_.size()); i++)
         {
-            std::cout << "Bin " << i + 1 << ": ";
-            for (const auto& item : bins_[i].getItems())
+            solutionOut << "Bin " << i + 1 << ": ";
+            for (int id : contents_.getItems(i))
             {
-                std::cout << "Item " << item.getId() << " (Size: " << item.getSize() << ") ";
+                const Item& item = items_[id];
+                solutionOut << "Item " << item.getId() << " (Size: " << item.getSize() << ") ";
             }
-            std::cout << std::endl;
+            solutionOut << '\n';
         }
     }
 
@@ -162,16 +197,18 @@ private:
     int maxBins_;
     int incrementStrategy_;
     int threshold_;
-    int binCapacity_ = 100;
-    std::vector<Item> items_;
-    std::vector<Bin> bins_;
+    int binCapacity_;
+    std::pmr::memory_resource* resource_;
+    std::pmr::vector<Item> items_;
+    std::pmr::vector<Bin> bins_;
+    BinContents contents_;
 };
 
 class HybridMultibin
 {
 public:
-    HybridMultibin(int maxBins, int batchIncrement, int binCapacity, int threshold)
-        : maxBins_(maxBins), batchIncrement_(batchIncrement), binCapacity_(binCapacity), threshold_(threshold) {}
+    HybridMultibin(int maxBins, int batchIncrement, int binCapacity, int threshold, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : maxBins_(maxBins), batchIncrement_(batchIncrement), binCapacity_(binCapacity), threshold_(threshold), resource_(resource), items_(resource), contents_(resource) {}
 
     void addItem(const Item& item)
     {
@@ -179,9 +216,9 @@ public:
     }
 
 
-    int calculateLowerBound(const std::vector<Item>& items, int binCapacity)
+    int calculateLowerBound(const std::pmr::vector<Item>& items, int binCapacity)
     {
-        int sumItemSizes = 0;
+        long long sumItemSizes = 0;
         for (const auto& item : items)
         {
             sumItemSizes += item.getSize();
@@ -189,8 +226,16 @@ public:
         return static_cast<int>(std::round(static_cast<double>(sumItemSizes) / binCapacity));
     }
 
+    // Writes the packing of the last successful run, see BinContents::writeAssignment.
+    bool writeAssignment(const std::string& path) const
+    {
+        return contents_.writeAssignment(path, items_.size());
+    }
+
     bool runHybridAlgorithm()
     {
+        // The engines allocate from resource_, so the one that succeeds hands its contents over by move.
+
         auto start_time = std::chrono::high_resolution_clock::now();
 
         // Calculate the lower bound
@@ -199,7 +244,7 @@ public:
         int currentBins = std::min(2 * lowerBound, maxBins_);
 
         // Stage 1: MB-BFD Algorithm
-        Multibin multibinBFD(currentBins, batchIncrement_, threshold_);
+        Multibin multibinBFD(currentBins, batchIncrement_, threshold_, binCapacity_, resource_);
 
         for (const auto& item : items_)
         {
@@ -209,26 +254,27 @@ public:
         bool success = multibinBFD.packItems();
         if (success)
         {
-            std::cout << "Successfully packed items into bins using the MB-BFD algorithm!" << std::endl;
-            multibinBFD.printBins();
+            solutionOut << "Successfully packed items into bins using the MB-BFD algorithm!" << '\n';
             auto end_time = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+            multibinBFD.printBins();
+            contents_ = multibinBFD.takeContents();
 
-            std::cout << "Execution time for MB-BFD: " << duration.count() << " microseconds" << std::endl;
+            solutionOut << "Execution time for MB-BFD: " << duration.count() << " microseconds" << '\n';
 
             return true;
         }
         else
         {
-            std::cout << "\nMB-BFD-based approach failed. Switching to MB-FFD algorithm..." << std::endl;
+            solutionOut << "\nMB-BFD-based approach failed. Switching to MB-FFD algorithm..." << '\n';
             auto end_time = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
-            std::cout << "\nExecution time for MB-BFD: " << duration.count() << " microseconds" << std::endl;
+            solutionOut << "\nExecution time for MB-BFD: " << duration.count() << " microseconds" << '\n';
         }
 
         // Stage 2: MB-FFD Algorithm
-        MBBinPacking multibinFFD(binCapacity_);
+        MBBinPacking multibinFFD(binCapacity_, resource_);
         for (const auto& item : items_)
         {
             multibinFFD.addItem(item);
@@ -236,20 +282,23 @@ public:
 
         if (multibinFFD.getNumBins() <= maxBins_)
         {
-            std::cout << "\nSuccessfully packed remaining items into bins using the MB-FFD algorithm!" << std::endl;
-            for (int i = 0; i < multibinFFD.getNumBins(); i++)
+            solutionOut << "\nSuccessfully packed remaining items into bins using the MB-FFD algorithm!" << '\n';
+            multibinFFD.buildContents();
+            auto end_time = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+            contents_ = multibinFFD.takeContents();
+            for (int i = 0; !solutionOut.isQuiet() && i < multibinFFD.getNumBins(); i++)
             {
-                std::cout << "Bin " << i + 1 << ": ";
-                for (const auto& item : multibinFFD.getBins()[i].getItems())
+                solutionOut << "Bin " << i + 1 << ": ";
+                for (int id : contents_.getItems(i))
                 {
-                    std::cout << "Item " << item.getId() << " (Size: " << item.getSize() << ") ";
+                    const Item& item = items_[id];
+                    solutionOut << "Item " << item.getId() << " (Size: " << item.getSize() << ") ";
                 }
-                std::cout << std::endl;
+                solutionOut << '\n';
             }
-            auto end_time = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
-            std::cout << "\nExecution time for MB-FFD: " << duration.count() << " microseconds" << std::endl;
+            solutionOut << "\nExecution time for MB-FFD: " << duration.count() << " microseconds" << '\n';
             return true;
         }
 
@@ -261,32 +310,104 @@ private:
     int batchIncrement_;
     int binCapacity_;
     int threshold_;
-    std::vector<Item> items_;
+    std::pmr::memory_resource* resource_;
+    std::pmr::vector<Item> items_;
+    BinContents contents_;
 };
 
 
 
-int main()
+// Reads a Falkenauer instance: the item count, the bin capacity, then one size per line.
+bool readInstance(const std::string& path, int& binCapacity, std::vector<int>& sizes)
+{
+    std::ifstream file(path);
+    size_t count = 0;
+    if (!(file >> count >> binCapacity) || binCapacity <= 0)
+    {
+        return false;
+    }
+    sizes.resize(count);
+    for (int& size : sizes)
+    {
+        if (!(file >> size) || size <= 0 || size > binCapacity)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
 {
+    // --quiet skips the bin listings. --instance reads a Falkenauer instance (item count,
+    // capacity, one size per line) in place of the built-in items, --assignment writes the
+    // bin of every item in the format largeInstance reads through --initial.
+    std::string instancePath;
+    std::string assignmentPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--quiet")
+        {
+            solutionOut.setQuiet(true);
+        }
+        else if (arg == "--instance" && i + 1 < argc)
+        {
+            instancePath = argv[++i];
+        }
+        else if (arg == "--assignment" && i + 1 < argc)
+        {
+            assignmentPath = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
     int maxBins = 3;
     int batchIncrement = 1;
     int binCapacity = 100;
+    std::vector<int> sizes;
+    if (!instancePath.empty())
+    {
+        if (!readInstance(instancePath, binCapacity, sizes))
+        {
+            std::cerr << "Cannot read the instance " << instancePath << std::endl;
+            return 1;
+        }
+        // Enough bins for every item to get one of its own
+        maxBins = std::max(maxBins, static_cast<int>(sizes.size()));
+    }
     int thresholdContainerVal = 80; 
 
     HybridMultibin hybridMultibin(maxBins, batchIncrement, binCapacity, thresholdContainerVal);
 
-    hybridMultibin.addItem(Item(1, 30));
-    hybridMultibin.addItem(Item(2, 40));
-    hybridMultibin.addItem(Item(3, 60));
-    hybridMultibin.addItem(Item(4, 70));
-    hybridMultibin.addItem(Item(5, 10));
-    hybridMultibin.addItem(Item(6, 80));
+    if (instancePath.empty())
+    {
+        hybridMultibin.addItem(Item(1, 30));
+        hybridMultibin.addItem(Item(2, 40));
+        hybridMultibin.addItem(Item(3, 60));
+        hybridMultibin.addItem(Item(4, 70));
+        hybridMultibin.addItem(Item(5, 10));
+        hybridMultibin.addItem(Item(6, 80));
+    }
+    for (size_t k = 0; k < sizes.size(); ++k)
+    {
+        hybridMultibin.addItem(Item(static_cast<int>(k) + 1, sizes[k]));
+    }
 
     bool success = hybridMultibin.runHybridAlgorithm();
 
     if (!success)
     {
-        std::cout << "Both MB-BFD and MB-FFD algorithms have failed. No feasible solution found." << std::endl;
+        solutionOut << "Both MB-BFD and MB-FFD algorithms have failed. No feasible solution found." << '\n';
+    }
+
+    if (!assignmentPath.empty() && !hybridMultibin.writeAssignment(assignmentPath))
+    {
+        std::cerr << "No complete packing to write to " << assignmentPath << std::endl;
+        return 1;
     }
 
     return 0;
@@ -1,12 +1,21 @@
 #include<iostream>
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
+#include <utility>
 #include <cmath>
 #include <numeric>
 #include <chrono>
+#include <string>
+#include <fstream>
+
+#include "../binContents.h"
+#include "../solutionWriter.h"
 
 // ---------------MB-BFD -> MB-FFD------------------
 
+SolutionWriter solutionOut;
+
 class Item
 {
 public:
@@ -22,7 +31,7 @@ private:
 class Bin
 {
 public:
-    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity) {}
+    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity), count_(0) {}
     bool canFit(const Item& item) const { return remaining_capacity_ >= item.getSize(); }
     bool addItem(const Item& item)
     {
@@ -31,61 +40,75 @@ public:
             return false;
         }
         remaining_capacity_ -= item.getSize();
-        items.push_back(item);
+        ++count_;
         return true;
     }
     bool isFull() const { return remaining_capacity_ == 0; }
     int getRemainingCapacity() const { return remaining_capacity_; }
-    const std::vector<Item>& getItems() const { return items; }
+    int getNumItems() const { return count_; }
 
 private:
     int capacity_;
     int remaining_capacity_;
-    std::vector<Item> items;
+    int count_;
 };
 
 class MBBinPacking
 {
 public:
-    MBBinPacking(int binCapacity) : binCapacity_(binCapacity) {}
+    MBBinPacking(int binCapacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : binCapacity_(binCapacity), bins_(resource), contents_(resource) {}
     void addItem(const Item& item);
     int getNumBins() const { return bins_.size(); }
-    const std::vector<Bin>& getBins() const { return bins_; }
+    const std::pmr::vector<Bin>& getBins() const { return bins_; }
+    const BinContents& getContents() const { return contents_; }
+    void buildContents() { contents_.build(getNumBins()); }
 
 private:
     int binCapacity_;
-    std::vector<Bin> bins_;
+    std::pmr::vector<Bin> bins_;
+    BinContents contents_;
+    int numItems_ = 0;
 };
 
+// Items are numbered in the order they are added, the contents hold these ids.
 void MBBinPacking::addItem(const Item& item)
 {
+    int id = numItems_++;
     auto it = std::min_element(bins_.begin(), bins_.end(), [&](const Bin& bin1, const Bin& bin2) {
         return bin1.getRemainingCapacity() < bin2.getRemainingCapacity() && bin1.canFit(item);
         });
 
     if (it != bins_.end()) {
-        it->addItem(item);
+        if (it->addItem(item)) {
+            contents_.add(id, static_cast<int>(it - bins_.begin()));
+        }
     }
     else {
         Bin new_bin(binCapacity_);
-        new_bin.addItem(item);
+        if (new_bin.addItem(item)) {
+            contents_.add(id, getNumBins());
+        }
         bins_.push_back(new_bin);
     }
 }
 
-bool packItemsIntoBins(std::vector<Item>& items, std::vector<Bin>& bins, int binCapacity)
+bool packItemsIntoBins(const std::pmr::vector<Item>& items, std::pmr::vector<Bin>& bins, BinContents& contents, int binCapacity)
 {
-    sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
-        return a.getSize() > b.getSize(); // Sort items in descending order
+    std::pmr::vector<int> order(items.size(), 0, bins.get_allocator());
+    std::iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        return items[a].getSize() > items[b].getSize(); // Sort item ids in descending order of size
         });
 
-    for (const auto& item : items)
+    for (int id : order)
     {
+        const Item& item = items[id];
         bool itemPacked = false;
         int bestFitBinIdx = -1;
         int minRemainingSpace = binCapacity + 1;
 
-        for (int i = 0; i < bins.size(); ++i)
+        for (int i = 0; i < static_cast<int>(bins.size()); ++i)
         {
             int remainingSpace = bins[i].getRemainingCapacity();
             if (remainingSpace >= item.getSize() && remainingSpace < minRemainingSpace)
@@ -98,6 +121,7 @@ bool packItemsIntoBins(std::vector<Item>& items, std::vector<Bin>& bins, int bin
         if (bestFitBinIdx != -1)
         {
             bins[bestFitBinIdx].addItem(item);
+            contents.add(id, bestFitBinIdx);
             itemPacked = true;
         }
 
@@ -112,23 +136,32 @@ bool packItemsIntoBins(std::vector<Item>& items, std::vector<Bin>& bins, int bin
 class Multibin
 {
 public:
-    Multibin(int maxBins, int incrementStrategy) : maxBins_(maxBins), incrementStrategy_(incrementStrategy) {}
+    Multibin(int maxBins, int incrementStrategy, int binCapacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : maxBins_(maxBins), incrementStrategy_(incrementStrategy), binCapacity_(binCapacity), resource_(resource), items_(resource), bins_(resource), contents_(resource) {}
 
     void addItem(const Item& item)
     {
         items_.push_back(item);
     }
 
+    const BinContents& getContents() const { return contents_; }
+
     bool packItems()
     {
+        // Allocated like bins_ and contents_, so the attempt that succeeds is moved in.
+        std::pmr::vector<Bin> activeBins(resource_);
+        BinContents activeContents(resource_);
         int n = 1;
         while (n <= maxBins_)
         {
-            std::vector<Bin> activeBins(n, Bin(binCapacity_));
-            bool success = packItemsIntoBins(items_, activeBins, binCapacity_);
+            activeBins.assign(n, Bin(binCapacity_));
+            activeContents.clear();
+            bool success = packItemsIntoBins(items_, activeBins, activeContents, binCapacity_);
             if (success)
             {
-                bins_ = activeBins;
+                bins_ = std::move(activeBins);
+                contents_ = std::move(activeContents);
+                contents_.build(n);
                 return true;
             }
 
@@ -147,39 +180,50 @@ public:
 
     void printBins() const
     {
-        for (int i = 0; i < bins_.size(); i++)
+        for (int i = 0; !solutionOut.isQuiet() && i < static_cast<int>(bins_.size()); i++)
         {
-            std::cout << "Bin " << i + 1 << ": ";
-            for (const auto& item : bins_[i].getItems())
+            solutionOut << "Bin " << i + 1 << ": ";
+            for (int id : contents_.getItems(i))
             {
-                std::cout << "Item " << item.getId() << " (Size: " << item.getSize() << ") ";
+                const Item& item = items_[id];
+                solutionOut << "Item " << item.getId() << " (Size: " << item.getSize() << ") ";
             }
-            std::cout << std::endl;
+            solutionOut << '\n';
         }
     }
 
 private:
     int maxBins_;
     int incrementStrategy_;
-    int binCapacity_ = 100;
-    std::vector<Item> items_;
-    std::vector<Bin> bins_;
+    int binCapacity_;
+    std::pmr::memory_resource* resource_;
+    std::pmr::vector<Item> items_;
+    std::pmr::vector<Bin> bins_;
+    BinContents contents_;
 };
 
 class HybridMultibin
 {
 public:
-    HybridMultibin(int maxBins, int batchIncrement, int binCapacity)
-        : maxBins_(maxBins), batchIncrement_(batchIncrement), binCapacity_(binCapacity) {}
+    HybridMultibin(int maxBins, int batchIncrement, int binCapacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : maxBins_(maxBins), batchIncrement_(batchIncrement), binCapacity_(binCapacity), resource_(resource), items_(resource), contents_(resource) {}
 
     void addItem(const Item& item);
     bool runHybridAlgorithm();
 
+    // Writes the packing of the last successful run, see BinContents::writeAssignment.
+    bool writeAssignment(const std::string& path) const
+    {
+        return contents_.writeAssignment(path, items_.size());
+    }
+
 private:
     int maxBins_;
     int batchIncrement_;
     int binCapacity_;
-    std::vector<Item> items_;
+    std::pmr::memory_resource* resource_;
+    std::pmr::vector<Item> items_;
+    BinContents contents_;
 };
 
 void HybridMultibin::addItem(const Item& item)
@@ -187,9 +231,9 @@ void HybridMultibin::addItem(const Item& item)
     items_.push_back(item);
 }
 
-int calculateLowerBound(const std::vector<Item>& items, int binCapacity)
+int calculateLowerBound(const std::pmr::vector<Item>& items, int binCapacity)
 {
-    int sumItemSizes = 0;
+    long long sumItemSizes = 0;
     for (const auto& item : items)
     {
         sumItemSizes += item.getSize();
@@ -199,6 +243,8 @@ int calculateLowerBound(const std::vector<Item>& items, int binCapacity)
 
 bool HybridMultibin::runHybridAlgorithm()
 {
+    std::pmr::monotonic_buffer_resource arena(resource_);
+
     auto start_time = std::chrono::high_resolution_clock::now(); // start the measure
 
     // Calculate the lower bound
@@ -208,7 +254,7 @@ bool HybridMultibin::runHybridAlgorithm()
     int threshold = std::max(lowerBound, static_cast<int>(items_.size() * 0.2)); // Adjust the threshold as needed
 
     // Stage 1: MB-BFD Algorithm
-    Multibin multibinBFD(maxBins_, batchIncrement_);
+    Multibin multibinBFD(maxBins_, batchIncrement_, binCapacity_, &arena);
     int stackedItems = 0;
 
     for (const auto& item : items_)
@@ -218,65 +264,158 @@ bool HybridMultibin::runHybridAlgorithm()
 
         if (stackedItems >= threshold)
         {
-            multibinBFD.packItems();
-            std::cout << "Successfully packed " << stackedItems << " items using MB-BFD algorithm!" << std::endl;
-            multibinBFD.printBins();
+            bool packedStacked = multibinBFD.packItems();
+            solutionOut << "Successfully packed " << stackedItems << " items using MB-BFD algorithm!" << '\n';
             auto end_time = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-            std::cout << "Execution time for MB-BFD: " << duration.count() << " microseconds" << std::endl;
+            multibinBFD.printBins();
+            solutionOut << "Execution time for MB-BFD: " << duration.count() << " microseconds" << '\n';
 
             // Stage 2: MB-FFD Algorithm for the remaining items
-            Multibin multibinFFD(binCapacity_,batchIncrement_);
-            for (int i = stackedItems; i < items_.size(); i++)
+            Multibin multibinFFD(binCapacity_, batchIncrement_, binCapacity_, &arena);
+            for (int i = stackedItems; i < static_cast<int>(items_.size()); i++)
             {
                 multibinFFD.addItem(items_[i]);
             }
 
             if (multibinFFD.packItems())
             {
-                std::cout << "Successfully packed remaining items into bins using the MB-FFD algorithm!" << std::endl;
-                multibinFFD.printBins();
+                solutionOut << "Successfully packed remaining items into bins using the MB-FFD algorithm!" << '\n';
                 auto end_time_ffd = std::chrono::high_resolution_clock::now();
                 auto duration_ffd = std::chrono::duration_cast<std::chrono::microseconds>(end_time_ffd - end_time);
-                std::cout << "Execution time for MB-FFD: " << duration_ffd.count() << " microseconds" << std::endl;
+                multibinFFD.printBins();
+                solutionOut << "Execution time for MB-FFD: " << duration_ffd.count() << " microseconds" << '\n';
+
+                // Both stages as one packing: the items and bins of stage 2 follow those of stage 1
+                if (packedStacked)
+                {
+                    const BinContents& stacked = multibinBFD.getContents();
+                    const BinContents& remaining = multibinFFD.getContents();
+                    contents_.clear();
+                    for (int b = 0; b < stacked.getNumBins(); ++b)
+                    {
+                        for (int id : stacked.getItems(b))
+                        {
+                            contents_.add(id, b);
+                        }
+                    }
+                    for (int b = 0; b < remaining.getNumBins(); ++b)
+                    {
+                        for (int id : remaining.getItems(b))
+                        {
+                            contents_.add(stackedItems + id, stacked.getNumBins() + b);
+                        }
+                    }
+                    contents_.build(stacked.getNumBins() + remaining.getNumBins());
+                }
                 return true;
             }
             else
             {
-                std::cout << "MB-FFD algorithm failed to find a solution for remaining items." << std::endl;
+                solutionOut << "MB-FFD algorithm failed to find a solution for remaining items." << '\n';
             }
 
             return true; // Successfully completed both stages
         }
     }
 
-    std::cout << "Failed to find a solution using the hybrid algorithm." << std::endl;
+    solutionOut << "Failed to find a solution using the hybrid algorithm." << '\n';
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-    std::cout << "Total execution time: " << duration.count() << " microseconds" << std::endl;
+    solutionOut << "Total execution time: " << duration.count() << " microseconds" << '\n';
     return false;
 }
 
-int main()
+// Reads a Falkenauer instance: the item count, the bin capacity, then one size per line.
+bool readInstance(const std::string& path, int& binCapacity, std::vector<int>& sizes)
+{
+    std::ifstream file(path);
+    size_t count = 0;
+    if (!(file >> count >> binCapacity) || binCapacity <= 0)
+    {
+        return false;
+    }
+    sizes.resize(count);
+    for (int& size : sizes)
+    {
+        if (!(file >> size) || size <= 0 || size > binCapacity)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
 {
+    // --quiet skips the bin listings. --instance reads a Falkenauer instance (item count,
+    // capacity, one size per line) in place of the built-in items, --assignment writes the
+    // bin of every item in the format largeInstance reads through --initial.
+    std::string instancePath;
+    std::string assignmentPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--quiet")
+        {
+            solutionOut.setQuiet(true);
+        }
+        else if (arg == "--instance" && i + 1 < argc)
+        {
+            instancePath = argv[++i];
+        }
+        else if (arg == "--assignment" && i + 1 < argc)
+        {
+            assignmentPath = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return 1;
+        }
+    }
     int maxBins = 3;
     int batchIncrement = 1;
     int binCapacity = 100;
+    std::vector<int> sizes;
+    if (!instancePath.empty())
+    {
+        if (!readInstance(instancePath, binCapacity, sizes))
+        {
+            std::cerr << "Cannot read the instance " << instancePath << std::endl;
+            return 1;
+        }
+        // Enough bins for every item to get one of its own
+        maxBins = std::max(maxBins, static_cast<int>(sizes.size()));
+    }
 
     HybridMultibin hybridMultibin(maxBins, batchIncrement, binCapacity);
 
-    hybridMultibin.addItem(Item(1, 30));
-    hybridMultibin.addItem(Item(2, 40));
-    hybridMultibin.addItem(Item(3, 60));
-    hybridMultibin.addItem(Item(4, 70));
-    hybridMultibin.addItem(Item(5, 10));
-    hybridMultibin.addItem(Item(6, 80));
+    if (instancePath.empty())
+    {
+        hybridMultibin.addItem(Item(1, 30));
+        hybridMultibin.addItem(Item(2, 40));
+        hybridMultibin.addItem(Item(3, 60));
+        hybridMultibin.addItem(Item(4, 70));
+        hybridMultibin.addItem(Item(5, 10));
+        hybridMultibin.addItem(Item(6, 80));
+    }
+    for (size_t k = 0; k < sizes.size(); ++k)
+    {
+        hybridMultibin.addItem(Item(static_cast<int>(k) + 1, sizes[k]));
+    }
 
     bool success = hybridMultibin.runHybridAlgorithm();
 
     if (!success)
     {
-        std::cout << "Both MB-BFD and MB-FFD algorithms have failed. No feasible solution found." << std::endl;
+        solutionOut << "Both MB-BFD and MB-FFD algorithms have failed. No feasible solution found." << '\n';
+    }
+
+    if (!assignmentPath.empty() && !hybridMultibin.writeAssignment(assignmentPath))
+    {
+        std::cerr << "No complete packing to write to " << assignmentPath << std::endl;
+        return 1;
     }
 
     return 0;
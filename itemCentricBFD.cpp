@@ -1,6 +1,11 @@
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
+#include <cstdint>
+#include <set>
+
+#include "binStore.h"
 
 class Item {
 public:
@@ -11,45 +16,85 @@ private:
     int size_;
 };
 
-class Bin {
+const FitScan bestFit = selectBestFit();
+
+// Ordered set of (remaining, bin) pairs. Only used above kTreeThreshold bins, below
+// that one SIMD scan of the remaining array is faster than the set lookup.
+// The best fit is the first pair not below (size, 0), which also takes the lowest
+// bin on ties like the scan does.
+class BestFitIndex {
 public:
-    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity) {}
-    bool canFit(const Item& item) const { return remaining_capacity_ >= item.getSize(); }
-    void addItem(const Item& item) { remaining_capacity_ -= item.getSize(); }
-    int getRemainingCapacity() const { return remaining_capacity_; }
+    static constexpr int kTreeThreshold = 256;
+
+    BestFitIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : tree_(resource), indexed_(resource) {}
+
+    // Call after the bins were reset.
+    void rebuild(const BinStore& bins) {
+        tree_.clear();
+        indexed_.clear();
+        active_ = bins.getNumBins() > kTreeThreshold;
+        if (!active_) {
+            return;
+        }
+        for (int b = 0; b < bins.getNumBins(); ++b) {
+            tree_.emplace(bins.getRemaining(b), b);
+            indexed_.push_back(bins.getRemaining(b));
+        }
+    }
+
+    // Call after the remaining capacity of bin changed or bin was opened.
+    void update(const BinStore& bins, int bin) {
+        if (!active_) {
+            if (bins.getNumBins() > kTreeThreshold) {
+                rebuild(bins);
+            }
+            return;
+        }
+        if (bin < static_cast<int>(indexed_.size())) {
+            tree_.erase(std::make_pair(indexed_[bin], bin));
+            indexed_[bin] = bins.getRemaining(bin);
+        }
+        else {
+            indexed_.push_back(bins.getRemaining(bin));
+        }
+        tree_.emplace(bins.getRemaining(bin), bin);
+    }
+
+    // Bin with the smallest remaining >= size, the first one on ties, or -1.
+    int find(const BinStore& bins, int32_t size) const {
+        if (!active_) {
+            return bestFit(bins.remaining(), bins.getNumBins(), size);
+        }
+        auto it = tree_.lower_bound(std::make_pair(size, 0));
+        return it != tree_.end() ? it->second : -1;
+    }
 
 private:
-    int capacity_;
-    int remaining_capacity_;
+    std::pmr::set<std::pair<int32_t, int>> tree_;
+    std::pmr::vector<int32_t> indexed_;
+    bool active_ = false;
 };
 
 class BinPackingBFD {
 public:
-    BinPackingBFD(int bin_capacity) : bin_capacity_(bin_capacity) {}
+    BinPackingBFD(int bin_capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bins_(bin_capacity, resource), index_(resource) {}
     void addItem(const Item& item);
-    int getNumBins() const { return bins_.size(); }
+    int getNumBins() const { return bins_.getNumBins(); }
 
 private:
-    int bin_capacity_;
-    std::vector<Bin> bins_;
+    BinStore bins_;
+    BestFitIndex index_;
 };
 
 void BinPackingBFD::addItem(const Item& item) {
-  
-    auto it = std::min_element(bins_.begin(), bins_.end(), [&](const Bin& bin1, const Bin& bin2) {
-        return bin1.getRemainingCapacity() < bin2.getRemainingCapacity() && bin1.canFit(item);
-        });
-
-    if (it != bins_.end()) {
-     
-        it->addItem(item);
-    }
-    else {
-       
-        Bin new_bin(bin_capacity_);
-        new_bin.addItem(item);
-        bins_.push_back(new_bin);
+    // Bin with the smallest remaining capacity that still holds the item
+    int bin = index_.find(bins_, item.getSize());
+    if (bin == -1) {
+        bin = bins_.openBin();
     }
+    bins_.addItem(bin, item.getSize());
+    index_.update(bins_, bin);
 }
 
 int main() {
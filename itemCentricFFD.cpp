@@ -1,6 +1,12 @@
 #include <iostream>
+#include <fstream>
+#include <string>
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
+#include <cstdint>
+
+#include "binStore.h"
 
 class Item {
 public:
@@ -11,48 +17,250 @@ private:
     int size_;
 };
 
-class Bin {
+const FitScan firstFit = selectFirstFit();
+
+// Max tree over blocks of BinStore::kLane bins. Only used above kTreeThreshold bins,
+// below that one SIMD scan of the remaining array is faster than walking the tree.
+// A search walks down to the first block that holds a fitting bin and scans only it.
+class FirstFitIndex {
 public:
-    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity) {}
-    bool canFit(const Item& item) const { return remaining_capacity_ >= item.getSize(); }
-    void addItem(const Item& item) { remaining_capacity_ -= item.getSize(); }
-    int getRemainingCapacity() const { return remaining_capacity_; }
+    static constexpr int kTreeThreshold = 512;
+
+    FirstFitIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : tree_(resource) {}
+
+    // Call after the bins were reset.
+    void rebuild(const BinStore& bins) {
+        int numBlocks = (bins.getNumBins() + BinStore::kLane - 1) / BinStore::kLane;
+        active_ = bins.getNumBins() > kTreeThreshold;
+        if (!active_) {
+            return;
+        }
+        leaves_ = 1;
+        while (leaves_ < numBlocks) {
+            leaves_ *= 2;
+        }
+        tree_.assign(2 * leaves_, -1);
+        for (int block = 0; block < numBlocks; ++block) {
+            tree_[leaves_ + block] = blockMax(bins, block);
+        }
+        for (int node = leaves_ - 1; node >= 1; --node) {
+            tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+        }
+    }
+
+    // Call after the remaining capacity of bin changed or bin was opened.
+    void update(const BinStore& bins, int bin) {
+        int block = bin / BinStore::kLane;
+        if (!active_ || block >= leaves_) {
+            if (bins.getNumBins() > kTreeThreshold) {
+                rebuild(bins);
+            }
+            return;
+        }
+        int node = leaves_ + block;
+        tree_[node] = blockMax(bins, block);
+        for (node /= 2; node >= 1; node /= 2) {
+            tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+        }
+    }
+
+    // First bin with remaining >= size, or -1.
+    int find(const BinStore& bins, int32_t size) const {
+        if (!active_) {
+            return firstFit(bins.remaining(), bins.getNumBins(), size);
+        }
+        if (tree_[1] < size) {
+            return -1;
+        }
+        int node = 1;
+        while (node < leaves_) {
+            node = tree_[2 * node] >= size ? 2 * node : 2 * node + 1;
+        }
+        int first = (node - leaves_) * BinStore::kLane;
+        return first + firstFit(bins.remaining() + first, BinStore::kLane, size);
+    }
 
 private:
-    int capacity_;
-    int remaining_capacity_;
+    static int32_t blockMax(const BinStore& bins, int block) {
+        const int32_t* remaining = bins.remaining() + block * BinStore::kLane;
+        int32_t result = -1;
+        for (int b = 0; b < BinStore::kLane; ++b) {
+            result = std::max(result, remaining[b]);
+        }
+        return result;
+    }
+
+    std::pmr::vector<int32_t> tree_;
+    int leaves_ = 0;
+    bool active_ = false;
 };
 
 class BinPacking {
 public:
-    BinPacking(int bin_capacity) : bin_capacity_(bin_capacity) {}
+    BinPacking(int bin_capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bins_(bin_capacity, resource), index_(resource) {}
     void addItem(const Item& item);
-    int getNumBins() const { return bins_.size(); }
+    int getNumBins() const { return bins_.getNumBins(); }
 
 private:
-    int bin_capacity_;
-    std::vector<Bin> bins_;
+    BinStore bins_;
+    FirstFitIndex index_;
 };
 
 void BinPacking::addItem(const Item& item) {
-    bool placed = false;
-    // Iteratinf over existing bins to find a suitable one for the item
-    for (auto& bin : bins_) {
-        if (bin.canFit(item)) {
-            bin.addItem(item);
-            placed = true;
-            break;
+    // First bin whose remaining capacity holds the item
+    int bin = index_.find(bins_, item.getSize());
+    if (bin == -1) {
+        bin = bins_.openBin();
+    }
+    bins_.addItem(bin, item.getSize());
+    index_.update(bins_, bin);
+}
+
+// Online first fit over an unbounded stream of items. A bin whose remaining capacity
+// is below the smallest item the stream may contain can never be used again, so it
+// is closed and written out at once. The slots of closed bins are dropped in batches,
+// memory grows with the number of open bins and not with the length of the stream.
+class StreamingBinPacking {
+public:
+    StreamingBinPacking(int bin_capacity, int min_item_size, std::ostream& out,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bins_(bin_capacity, resource), index_(resource), binIds_(resource), binItems_(resource),
+          minItemSize_(min_item_size), out_(out) {}
+
+    void addItem(const Item& item);
+    // Closes every bin still open, call at the end of the stream.
+    void finish();
+    int64_t getNumBins() const { return numBinsOpened_; }
+    int getNumOpenBins() const { return bins_.getNumBins() - numClosed_; }
+
+private:
+    struct PackedItem {
+        int64_t id;
+        int size;
+    };
+
+    void closeBin(int slot);
+
+    BinStore bins_;
+    FirstFitIndex index_;
+    std::pmr::vector<int64_t> binIds_;
+    std::pmr::vector<std::pmr::vector<PackedItem>> binItems_;
+    int minItemSize_;
+    std::ostream& out_;
+    int64_t numItems_ = 0;
+    int64_t numBinsOpened_ = 0;
+    int numClosed_ = 0;
+};
+
+void StreamingBinPacking::addItem(const Item& item) {
+    int slot = index_.find(bins_, item.getSize());
+    if (slot == -1) {
+        slot = bins_.openBin();
+        binIds_.push_back(++numBinsOpened_);
+        if (slot < static_cast<int>(binItems_.size())) {
+            binItems_[slot].clear();
+        } else {
+            binItems_.emplace_back();
+        }
+    }
+    bins_.addItem(slot, item.getSize());
+    binItems_[slot].push_back({ ++numItems_, item.getSize() });
+    if (bins_.getRemaining(slot) < minItemSize_) {
+        closeBin(slot);
+    }
+    index_.update(bins_, slot);
+
+    // Drop the closed slots once they are half of the store, so the scan stays short
+    // and the cost of moving the open ones is spread over the bins that were closed.
+    if (numClosed_ >= BinStore::kLane && 2 * numClosed_ >= bins_.getNumBins()) {
+        int kept = 0;
+        for (int b = 0; b < bins_.getNumBins(); ++b) {
+            if (bins_.getRemaining(b) != -1) {
+                binIds_[kept] = binIds_[b];
+                std::swap(binItems_[kept], binItems_[b]);
+                ++kept;
+            }
         }
+        binIds_.resize(kept);
+        bins_.removeClosed();
+        index_.rebuild(bins_);
+        numClosed_ = 0;
     }
+}
 
-    if (!placed) {
-        Bin new_bin(bin_capacity_);
-        new_bin.addItem(item);
-        bins_.push_back(new_bin);
+void StreamingBinPacking::closeBin(int slot) {
+    out_ << "Bin " << binIds_[slot] << ":";
+    for (const PackedItem& item : binItems_[slot]) {
+        out_ << " Item " << item.id << " (Size: " << item.size << ")";
     }
+    out_ << "\n";
+    binItems_[slot].clear();
+    bins_.closeBin(slot);
+    ++numClosed_;
 }
 
-int main() {
+void StreamingBinPacking::finish() {
+    for (int b = 0; b < bins_.getNumBins(); ++b) {
+        if (bins_.getRemaining(b) != -1) {
+            closeBin(b);
+        }
+    }
+    out_.flush();
+}
+
+// Reads whitespace separated item sizes from in until the end of the stream.
+int runStream(std::istream& in, int bin_capacity, int min_item_size) {
+    StreamingBinPacking packing(bin_capacity, min_item_size, std::cout);
+    int size;
+    while (in >> size) {
+        if (size < min_item_size || size > bin_capacity) {
+            std::cerr << "Item of size " << size << " outside [" << min_item_size << ", " << bin_capacity << "]" << std::endl;
+            return 1;
+        }
+        packing.addItem(Item(size));
+    }
+    if (!in.eof()) {
+        std::cerr << "Invalid item size in the stream" << std::endl;
+        return 1;
+    }
+    packing.finish();
+    std::cout << "Number of bins used: " << packing.getNumBins() << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        // Streaming mode: itemCentricFFD --stream [file|-] [--capacity C] [--min-size S]
+        std::string path = "-";
+        int bin_capacity = 10;
+        int min_item_size = 1;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--capacity" && i + 1 < argc) {
+                bin_capacity = std::stoi(argv[++i]);
+            } else if (arg == "--min-size" && i + 1 < argc) {
+                min_item_size = std::stoi(argv[++i]);
+            } else if (arg != "--stream") {
+                path = arg;
+            }
+        }
+        if (min_item_size < 1 || min_item_size > bin_capacity) {
+            std::cerr << "Invalid minimum item size " << min_item_size << std::endl;
+            return 1;
+        }
+        if (path == "-") {
+            std::ios::sync_with_stdio(false);
+            return runStream(std::cin, bin_capacity, min_item_size);
+        }
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "Cannot open " << path << std::endl;
+            return 1;
+        }
+        return runStream(file, bin_capacity, min_item_size);
+    }
+
     int bin_capacity = 10;
     std::vector<int> item_sizes = { 6, 7, 3, 4, 5, 8, 2, 9, 5 };
 
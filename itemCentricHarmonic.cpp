@@ -0,0 +1,74 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+class Item {
+public:
+    Item(int size) : size_(size) {}
+    int getSize() const { return size_; }
+
+private:
+    int size_;
+};
+
+// Harmonic-k: an item of size s in (C / (j + 1), C / j] belongs to class j = C / s,
+// items not above C / k all go to class k. Every class keeps one open bin, a class j < k
+// bin takes exactly j items and class k is packed with Next-Fit. O(k) memory and O(1)
+// time per item, about 1.69 * L1 bins for large k.
+class BinPackingHarmonic {
+public:
+    BinPackingHarmonic(int bin_capacity, int num_classes)
+        : bin_capacity_(bin_capacity), num_classes_(num_classes), remaining_(num_classes + 1, 0) {}
+    void addItem(const Item& item);
+    int64_t getNumBins() const { return num_bins_; }
+    // L1 lower bound: total size divided by the capacity, rounded up.
+    int64_t getLowerBound() const { return (total_size_ + bin_capacity_ - 1) / bin_capacity_; }
+
+private:
+    int bin_capacity_;
+    int num_classes_;
+    // Open bin of every class: free item slots for j < k, free capacity for class k.
+    std::vector<int> remaining_;
+    int64_t num_bins_ = 0;
+    int64_t total_size_ = 0;
+};
+
+void BinPackingHarmonic::addItem(const Item& item) {
+    int size = item.getSize();
+    int j = std::min(num_classes_, bin_capacity_ / std::max(size, 1));
+    total_size_ += size;
+    if (j < num_classes_) {
+        if (remaining_[j] == 0) {
+            ++num_bins_;
+            remaining_[j] = j;
+        }
+        --remaining_[j];
+        return;
+    }
+    if (size > remaining_[j]) {
+        ++num_bins_;
+        remaining_[j] = bin_capacity_;
+    }
+    remaining_[j] -= size;
+}
+
+int main() {
+    int bin_capacity = 10; // Capacity of each bin
+    int num_classes = 4;
+    std::vector<int> item_sizes = { 6, 7, 3, 4, 5, 8, 2, 9, 5 };
+
+    BinPackingHarmonic bin_packing(bin_capacity, num_classes);
+
+    for (int size : item_sizes) {
+        Item item(size);
+        bin_packing.addItem(item);
+    }
+
+    int64_t bound = bin_packing.getLowerBound();
+    std::cout << "Number of bins used: " << bin_packing.getNumBins() << std::endl;
+    std::cout << "L1 lower bound: " << bound << std::endl;
+    std::cout << "Overhead against L1: " << 100.0 * (bin_packing.getNumBins() - bound) / bound << "%" << std::endl;
+
+    return 0;
+}
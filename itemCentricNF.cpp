@@ -0,0 +1,58 @@
+#include <iostream>
+#include <vector>
+#include <cstdint>
+
+class Item {
+public:
+    Item(int size) : size_(size) {}
+    int getSize() const { return size_; }
+
+private:
+    int size_;
+};
+
+// Next-Fit: only the most recently opened bin accepts items, when an item does not fit
+// it is closed for good and a new one is opened. O(1) memory and time per item, at most
+// 2 * L1 bins.
+class BinPackingNF {
+public:
+    BinPackingNF(int bin_capacity) : bin_capacity_(bin_capacity) {}
+    void addItem(const Item& item);
+    int64_t getNumBins() const { return num_bins_; }
+    // L1 lower bound: total size divided by the capacity, rounded up.
+    int64_t getLowerBound() const { return (total_size_ + bin_capacity_ - 1) / bin_capacity_; }
+
+private:
+    int bin_capacity_;
+    int remaining_ = 0;
+    int64_t num_bins_ = 0;
+    int64_t total_size_ = 0;
+};
+
+void BinPackingNF::addItem(const Item& item) {
+    if (num_bins_ == 0 || item.getSize() > remaining_) {
+        ++num_bins_;
+        remaining_ = bin_capacity_;
+    }
+    remaining_ -= item.getSize();
+    total_size_ += item.getSize();
+}
+
+int main() {
+    int bin_capacity = 10; // Capacity of each bin
+    std::vector<int> item_sizes = { 6, 7, 3, 4, 5, 8, 2, 9, 5 };
+
+    BinPackingNF bin_packing(bin_capacity);
+
+    for (int size : item_sizes) {
+        Item item(size);
+        bin_packing.addItem(item);
+    }
+
+    int64_t bound = bin_packing.getLowerBound();
+    std::cout << "Number of bins used: " << bin_packing.getNumBins() << std::endl;
+    std::cout << "L1 lower bound: " << bound << std::endl;
+    std::cout << "Overhead against L1: " << 100.0 * (bin_packing.getNumBins() - bound) / bound << "%" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+class Item {
+public:
+    Item(int size) : size_(size) {}
+    int getSize() const { return size_; }
+
+private:
+    int size_;
+};
+
+// Next-Fit-Decreasing by size class: items are bucketed into the Harmonic classes
+// (C / (j + 1), C / j] as they arrive, pack() then runs Next-Fit over the classes from
+// the largest items to the smallest. Bucketing replaces the sort of NFD, so the time per
+// item stays O(1), but the batch has to be buffered until pack().
+class BinPackingNFD {
+public:
+    BinPackingNFD(int bin_capacity, int num_classes)
+        : bin_capacity_(bin_capacity), num_classes_(num_classes), classes_(num_classes + 1) {}
+    void addItem(const Item& item);
+    void pack();
+    int64_t getNumBins() const { return num_bins_; }
+    // L1 lower bound: total size divided by the capacity, rounded up.
+    int64_t getLowerBound() const { return (total_size_ + bin_capacity_ - 1) / bin_capacity_; }
+
+private:
+    int bin_capacity_;
+    int num_classes_;
+    std::vector<std::vector<int>> classes_;
+    int64_t num_bins_ = 0;
+    int64_t total_size_ = 0;
+};
+
+void BinPackingNFD::addItem(const Item& item) {
+    int size = item.getSize();
+    classes_[std::min(num_classes_, bin_capacity_ / std::max(size, 1))].push_back(size);
+    total_size_ += size;
+}
+
+void BinPackingNFD::pack() {
+    int remaining = 0;
+    num_bins_ = 0;
+    for (int j = 1; j <= num_classes_; ++j) {
+        for (int size : classes_[j]) {
+            if (num_bins_ == 0 || size > remaining) {
+                ++num_bins_;
+                remaining = bin_capacity_;
+            }
+            remaining -= size;
+        }
+    }
+}
+
+int main() {
+    int bin_capacity = 10; // Capacity of each bin
+    int num_classes = 4;
+    std::vector<int> item_sizes = { 6, 7, 3, 4, 5, 8, 2, 9, 5 };
+
+    BinPackingNFD bin_packing(bin_capacity, num_classes);
+
+    for (int size : item_sizes) {
+        Item item(size);
+        bin_packing.addItem(item);
+    }
+    bin_packing.pack();
+
+    int64_t bound = bin_packing.getLowerBound();
+    std::cout << "Number of bins used: " << bin_packing.getNumBins() << std::endl;
+    std::cout << "L1 lower bound: " << bound << std::endl;
+    std::cout << "Overhead against L1: " << 100.0 * (bin_packing.getNumBins() - bound) / bound << "%" << std::endl;
+
+    return 0;
+}
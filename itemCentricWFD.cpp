@@ -1,6 +1,10 @@
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
+#include <cstdint>
+
+#include "binStore.h"
 
 class Item {
 public:
@@ -11,45 +15,104 @@ private:
     int size_;
 };
 
-class Bin {
+const FitScan worstFit = selectWorstFit();
+
+// Max tree over blocks of BinStore::kLane bins. Only used above kTreeThreshold bins,
+// below that one SIMD scan of the remaining array is faster than walking the tree.
+// A search walks down to the first block that holds a fitting bin and scans only it.
+class WorstFitIndex {
 public:
-    Bin(int capacity) : capacity_(capacity), remaining_capacity_(capacity) {}
-    bool canFit(const Item& item) const { return remaining_capacity_ >= item.getSize(); }
-    void addItem(const Item& item) { remaining_capacity_ -= item.getSize(); }
-    int getRemainingCapacity() const { return remaining_capacity_; }
+    static constexpr int kTreeThreshold = 256;
+
+    WorstFitIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : tree_(resource) {}
+
+    // Call after the bins were reset.
+    void rebuild(const BinStore& bins) {
+        int numBlocks = (bins.getNumBins() + BinStore::kLane - 1) / BinStore::kLane;
+        active_ = bins.getNumBins() > kTreeThreshold;
+        if (!active_) {
+            return;
+        }
+        leaves_ = 1;
+        while (leaves_ < numBlocks) {
+            leaves_ *= 2;
+        }
+        tree_.assign(2 * leaves_, -1);
+        for (int block = 0; block < numBlocks; ++block) {
+            tree_[leaves_ + block] = blockMax(bins, block);
+        }
+        for (int node = leaves_ - 1; node >= 1; --node) {
+            tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+        }
+    }
+
+    // Call after the remaining capacity of bin changed or bin was opened.
+    void update(const BinStore& bins, int bin) {
+        int block = bin / BinStore::kLane;
+        if (!active_ || block >= leaves_) {
+            if (bins.getNumBins() > kTreeThreshold) {
+                rebuild(bins);
+            }
+            return;
+        }
+        int node = leaves_ + block;
+        tree_[node] = blockMax(bins, block);
+        for (node /= 2; node >= 1; node /= 2) {
+            tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+        }
+    }
+
+    // Bin with the largest remaining, the first one on ties, if it holds size; or -1.
+    int find(const BinStore& bins, int32_t size) const {
+        if (!active_) {
+            return worstFit(bins.remaining(), bins.getNumBins(), size);
+        }
+        if (tree_[1] < size) {
+            return -1;
+        }
+        int node = 1;
+        while (node < leaves_) {
+            node = tree_[2 * node] == tree_[1] ? 2 * node : 2 * node + 1;
+        }
+        int first = (node - leaves_) * BinStore::kLane;
+        return first + worstFit(bins.remaining() + first, BinStore::kLane, size);
+    }
 
 private:
-    int capacity_;
-    int remaining_capacity_;
+    static int32_t blockMax(const BinStore& bins, int block) {
+        const int32_t* remaining = bins.remaining() + block * BinStore::kLane;
+        int32_t result = -1;
+        for (int b = 0; b < BinStore::kLane; ++b) {
+            result = std::max(result, remaining[b]);
+        }
+        return result;
+    }
+
+    std::pmr::vector<int32_t> tree_;
+    int leaves_ = 0;
+    bool active_ = false;
 };
 
 class BinPackingBFD {
 public:
-    BinPackingBFD(int bin_capacity) : bin_capacity_(bin_capacity) {}
+    BinPackingBFD(int bin_capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bins_(bin_capacity, resource), index_(resource) {}
     void addItem(const Item& item);
-    int getNumBins() const { return bins_.size(); }
+    int getNumBins() const { return bins_.getNumBins(); }
 
 private:
-    int bin_capacity_;
-    std::vector<Bin> bins_;
+    BinStore bins_;
+    WorstFitIndex index_;
 };
 
 void BinPackingBFD::addItem(const Item& item) {
-  
-    auto it = std::min_element(bins_.begin(), bins_.end(), [&](const Bin& bin1, const Bin& bin2) {
-        return bin1.getRemainingCapacity() > bin2.getRemainingCapacity() && bin1.canFit(item);
-        });
-
-    if (it != bins_.end()) {
-     
-        it->addItem(item);
-    }
-    else {
-       
-        Bin new_bin(bin_capacity_);
-        new_bin.addItem(item);
-        bins_.push_back(new_bin);
+    // Bin with the largest remaining capacity, if it holds the item
+    int bin = index_.find(bins_, item.getSize());
+    if (bin == -1) {
+        bin = bins_.openBin();
     }
+    bins_.addItem(bin, item.getSize());
+    index_.update(bins_, bin);
 }
 
 int main() {
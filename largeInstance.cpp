@@ -0,0 +1,3337 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <type_traits>
+#include <memory_resource>
+#include <set>
+#include <random>
+#include <functional>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <utility>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// ---------------Large-instance FFD / BFD-------------------
+//
+// One-dimensional FFD and BFD for instances with up to 2^32 - 1 items and
+// capacities up to 2^32 - 1. There are no per-item or per-bin objects: item sizes,
+// the packing order and the bin of every item are uint32_t arrays, bin residuals
+// are a uint32_t array and every volume is summed in 64 bits. A 100M-item
+// instance needs about 4 * 100M bytes per array. BFD buckets the bins by residual,
+// which takes memory in proportion to the capacity, up to a capacity of 2^24; above
+// that the bins sit in a set ordered by residual, so memory grows with the bins.
+//
+// Input: the binary format written by data/create_multi_dim.cpp (--binary, dim 1),
+// a Falkenauer .txt file (n, capacity, one size per line) or a one-dimensional .vbp
+// file (1, capacity, n, "size [demand]" per line).
+//
+// Every array of a run is allocated from one monotonic arena that is released in
+// one go at the end; with --huge-pages the arena maps its chunks with transparent
+// huge pages.
+
+// Upstream of the run arena that maps its chunks directly and asks for transparent
+// huge pages, so the index arrays need far fewer TLB entries. Falls back to the
+// default resource where mmap is not available.
+class HugePageResource : public std::pmr::memory_resource
+{
+public:
+    static constexpr size_t kHugePage = size_t(2) << 20;
+    static constexpr size_t kPage = size_t(4) << 10;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+#ifdef __linux__
+        // mmap returns page-aligned memory, enough for any alignment the arena asks for.
+        if (alignment > kPage)
+        {
+            throw std::bad_alloc();
+        }
+        void* p = mmap(nullptr, roundUp(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        madvise(p, roundUp(bytes), MADV_HUGEPAGE);
+        return p;
+#else
+        return std::pmr::get_default_resource()->allocate(bytes, alignment);
+#endif
+    }
+
+    void do_deallocate(void* p, size_t bytes, [[maybe_unused]] size_t alignment) override
+    {
+#ifdef __linux__
+        munmap(p, roundUp(bytes));
+#else
+        std::pmr::get_default_resource()->deallocate(p, bytes, alignment);
+#endif
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    static size_t roundUp(size_t bytes) { return (bytes + kHugePage - 1) / kHugePage * kHugePage; }
+};
+
+class LargeInstance
+{
+public:
+    LargeInstance(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : sizes(resource) {}
+
+    uint32_t capacity = 0;
+    std::pmr::vector<uint32_t> sizes;
+
+    uint32_t getNumItems() const { return static_cast<uint32_t>(sizes.size()); }
+
+    uint64_t totalSize() const
+    {
+        uint64_t total = 0;
+        for (uint32_t size : sizes)
+        {
+            total += size;
+        }
+        return total;
+    }
+
+    uint64_t lowerBound() const { return (totalSize() + capacity - 1) / capacity; }
+};
+
+bool readBinary(std::istream& in, LargeInstance& instance)
+{
+    char magic[4];
+    uint32_t dim = 0;
+    uint64_t n = 0;
+    if (!in.read(magic, 4) || std::memcmp(magic, "VBPB", 4) != 0
+        || !in.read(reinterpret_cast<char*>(&dim), sizeof(dim)) || !in.read(reinterpret_cast<char*>(&n), sizeof(n)))
+    {
+        return false;
+    }
+    if (dim != 1 || n > UINT32_MAX)
+    {
+        std::cerr << "Large-instance mode needs a one-dimensional instance with fewer than 2^32 items" << std::endl;
+        return false;
+    }
+    instance.sizes.resize(n);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&instance.capacity), sizeof(uint32_t))
+        && in.read(reinterpret_cast<char*>(instance.sizes.data()), n * sizeof(uint32_t)));
+}
+
+// Reads the text formats in chunks, number by number. For .vbp files every item
+// line may carry a demand after the size, so lines are tracked as well.
+bool readText(std::istream& in, LargeInstance& instance, bool vbp)
+{
+    std::vector<char> buffer(1 << 20);
+    std::vector<uint64_t> header;
+    uint64_t numItems = 0;
+    uint64_t lineValues = 0;
+    uint64_t pendingSize = 0;
+    size_t kept = 0;
+    const size_t headerSize = vbp ? 3 : 2;
+
+    auto endLine = [&]() {
+        if (vbp && lineValues == 1)
+        {
+            instance.sizes.push_back(static_cast<uint32_t>(pendingSize));
+        }
+        lineValues = 0;
+    };
+    auto value = [&](uint64_t v) {
+        if (header.size() < headerSize)
+        {
+            header.push_back(v);
+            if (header.size() == headerSize)
+            {
+                numItems = vbp ? header[2] : header[0];
+                instance.capacity = static_cast<uint32_t>(header[1]);
+                instance.sizes.reserve(numItems);
+            }
+            return;
+        }
+        if (!vbp)
+        {
+            instance.sizes.push_back(static_cast<uint32_t>(v));
+            return;
+        }
+        if (lineValues == 0)
+        {
+            pendingSize = v;
+        }
+        else if (lineValues == 1)
+        {
+            instance.sizes.insert(instance.sizes.end(), v, static_cast<uint32_t>(pendingSize));
+        }
+        ++lineValues;
+    };
+
+    while (true)
+    {
+        in.read(buffer.data() + kept, buffer.size() - kept);
+        size_t filled = kept + static_cast<size_t>(in.gcount());
+        bool eof = filled == kept;
+        const char* pos = buffer.data();
+        const char* end = buffer.data() + filled;
+        // Keep a trailing partial number for the next chunk.
+        const char* stop = end;
+        if (!eof)
+        {
+            while (stop > pos && stop[-1] >= '0' && stop[-1] <= '9')
+            {
+                --stop;
+            }
+        }
+        while (pos < stop)
+        {
+            if (*pos >= '0' && *pos <= '9')
+            {
+                uint64_t v = 0;
+                pos = std::from_chars(pos, stop, v).ptr;
+                value(v);
+            }
+            else
+            {
+                if (*pos == '\n' && header.size() == headerSize)
+                {
+                    endLine();
+                }
+                ++pos;
+            }
+        }
+        kept = end - stop;
+        std::memmove(buffer.data(), stop, kept);
+        if (eof)
+        {
+            endLine();
+            break;
+        }
+    }
+
+    if (vbp && header.size() == headerSize && header[0] != 1)
+    {
+        std::cerr << "Large-instance mode needs a one-dimensional instance" << std::endl;
+        return false;
+    }
+    return header.size() == headerSize && instance.capacity > 0;
+}
+
+// Item indices by decreasing size. Counting sort when the capacity is small enough
+// for a count array, std::sort otherwise.
+std::pmr::vector<uint32_t> decreasingOrder(const LargeInstance& instance, std::pmr::memory_resource* resource)
+{
+    uint32_t n = instance.getNumItems();
+    std::pmr::vector<uint32_t> order(n, resource);
+    if (instance.capacity <= (1u << 24))
+    {
+        std::pmr::vector<uint32_t> start(static_cast<size_t>(instance.capacity) + 2, 0, resource);
+        for (uint32_t size : instance.sizes)
+        {
+            ++start[instance.capacity - size + 1];
+        }
+        for (size_t s = 1; s < start.size(); ++s)
+        {
+            start[s] += start[s - 1];
+        }
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            order[start[instance.capacity - instance.sizes[i]]++] = i;
+        }
+        return order;
+    }
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return instance.sizes[a] > instance.sizes[b];
+        });
+    return order;
+}
+
+// ---------------Reduction-------------------
+//
+// Martello-Toth reduction (MTRP) restricted to bins of at most two items: for the
+// largest free item j, let k be the largest other free item that fits with it. The bin
+// {j, k} dominates every other bin holding j, and can be fixed without losing the
+// optimum, when
+// - nothing fits with j (the bin is {j} alone),
+// - k fills the bin exactly, or
+// - j has room for at most two partners and no pair of them sums to more than k.
+// Otherwise j stays free and the next item is tried. The items are scanned once in
+// decreasing order: k moves with a pointer that only walks towards larger items, and
+// taken items are skipped through next/previous free links with path halving. The
+// fixed bins come first and the other items form the residual instance that the later
+// stages pack.
+class Reduction
+{
+public:
+    // Pairs with a given larger partner are checked for at most this many partners;
+    // past that j is left free.
+    static constexpr uint32_t kMaxPairScan = 16;
+
+    Reduction(const LargeInstance& instance, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : instance_(instance), order_(resource), sizes_(resource), next_(resource), prev_(resource) {}
+
+    // Returns the number of fixed bins. binOf gets the fixed bin of every fixed item,
+    // residual the other items and items the original index of every residual item.
+    uint32_t reduce(std::pmr::vector<uint32_t>& binOf, LargeInstance& residual, std::pmr::vector<uint32_t>& items)
+    {
+        uint32_t n = instance_.getNumItems();
+        uint32_t capacity = instance_.capacity;
+        // Sorted input, as at the nodes of BranchAndBound, keeps its order.
+        if (std::is_sorted(instance_.sizes.begin(), instance_.sizes.end(), std::greater<uint32_t>()))
+        {
+            order_.resize(n);
+            std::iota(order_.begin(), order_.end(), 0u);
+        }
+        else
+        {
+            order_ = decreasingOrder(instance_, order_.get_allocator().resource());
+        }
+        sizes_.resize(n);
+        for (uint32_t p = 0; p < n; ++p)
+        {
+            sizes_[p] = instance_.sizes[order_[p]];
+        }
+        // next_[p] leads to the first free position >= p and prev_[p + 1] to the last free
+        // position <= p, plus one; n and 0 are the sentinels.
+        next_.resize(size_t(n) + 1);
+        prev_.resize(size_t(n) + 1);
+        for (uint32_t p = 0; p <= n; ++p)
+        {
+            next_[p] = p;
+            prev_[p] = p;
+        }
+        binOf.assign(n, UINT32_MAX);
+
+        uint32_t fixed = 0;
+        uint32_t fit = n;
+        for (uint32_t j = nextFree(0); j < n; j = nextFree(j + 1))
+        {
+            uint32_t room = capacity - sizes_[j];
+            while (fit > 0 && sizes_[fit - 1] <= room)
+            {
+                --fit;
+            }
+            uint32_t k = nextOther(fit, j);
+            if (k < n && !dominates(j, k, room))
+            {
+                continue;
+            }
+            binOf[order_[j]] = fixed;
+            take(j);
+            if (k < n)
+            {
+                binOf[order_[k]] = fixed;
+                take(k);
+            }
+            ++fixed;
+        }
+
+        residual.capacity = capacity;
+        residual.sizes.clear();
+        items.clear();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            if (binOf[i] == UINT32_MAX)
+            {
+                items.push_back(i);
+                residual.sizes.push_back(instance_.sizes[i]);
+            }
+        }
+        return fixed;
+    }
+
+private:
+    // Whether {j, k}, with k the largest free partner of j, dominates every bin with j.
+    bool dominates(uint32_t j, uint32_t k, uint32_t room)
+    {
+        uint32_t n = instance_.getNumItems();
+        if (sizes_[k] == room)
+        {
+            return true;
+        }
+        // The sizes of the three smallest free items other than j.
+        uint32_t smallest[3];
+        uint32_t count = 0;
+        for (uint32_t slot = lastOther(n, j); slot != 0 && count < 3; slot = lastOther(slot - 1, j))
+        {
+            smallest[count++] = sizes_[slot - 1];
+        }
+        if (count < 2 || uint64_t(smallest[0]) + smallest[1] > room)
+        {
+            return true;
+        }
+        if (count == 3 && uint64_t(smallest[0]) + smallest[1] + smallest[2] <= room)
+        {
+            return false;
+        }
+        // At most two partners fit: look for a pair larger than k, larger partner first.
+        uint32_t scanned = 0;
+        for (uint32_t a = k; a < n; a = nextOther(a + 1, j))
+        {
+            if (2ull * sizes_[a] <= sizes_[k])
+            {
+                return true;
+            }
+            if (++scanned > kMaxPairScan)
+            {
+                return false;
+            }
+            uint32_t rest = room - sizes_[a];
+            uint32_t from = static_cast<uint32_t>(std::lower_bound(sizes_.begin(), sizes_.end(), rest, std::greater<uint32_t>()) - sizes_.begin());
+            uint32_t b = nextOther(std::max(from, a + 1), j);
+            if (b < n && sizes_[a] + sizes_[b] > sizes_[k])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void take(uint32_t p)
+    {
+        next_[p] = p + 1;
+        prev_[p + 1] = p;
+    }
+
+    // First free position >= p, n if there is none.
+    uint32_t nextFree(uint32_t p)
+    {
+        while (next_[p] != p)
+        {
+            next_[p] = next_[next_[p]];
+            p = next_[p];
+        }
+        return p;
+    }
+
+    // Last free position below slot, plus one; 0 if there is none.
+    uint32_t lastFree(uint32_t slot)
+    {
+        while (prev_[slot] != slot)
+        {
+            prev_[slot] = prev_[prev_[slot]];
+            slot = prev_[slot];
+        }
+        return slot;
+    }
+
+    uint32_t nextOther(uint32_t p, uint32_t j)
+    {
+        p = nextFree(p);
+        return p == j ? nextFree(j + 1) : p;
+    }
+
+    uint32_t lastOther(uint32_t slot, uint32_t j)
+    {
+        slot = lastFree(slot);
+        return slot == j + 1 ? lastFree(j) : slot;
+    }
+
+    const LargeInstance& instance_;
+    std::pmr::vector<uint32_t> order_;
+    std::pmr::vector<uint32_t> sizes_;
+    std::pmr::vector<uint32_t> next_;
+    std::pmr::vector<uint32_t> prev_;
+};
+
+// First fit index: bin residuals plus a max tree over blocks of kLeaf bins.
+// Finding the first bin with residual >= size descends the tree to the leftmost
+// block that can hold the item and scans its kLeaf residuals.
+class FirstFitTree
+{
+public:
+    static constexpr uint32_t kLeaf = 16;
+
+    FirstFitTree(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : residual_(resource), tree_(resource), numBins_(0), numBlocks_(0) {}
+
+    uint32_t getNumBins() const { return numBins_; }
+    const std::pmr::vector<uint32_t>& getResiduals() const { return residual_; }
+
+    // Returns the first bin that can hold the item, or UINT32_MAX.
+    uint32_t findBin(uint32_t size) const
+    {
+        if (numBins_ == 0 || tree_[1] < size)
+        {
+            return UINT32_MAX;
+        }
+        if (size == 0)
+        {
+            return 0;
+        }
+        size_t node = 1;
+        while (node < numBlocks_)
+        {
+            node = tree_[2 * node] >= size ? 2 * node : 2 * node + 1;
+        }
+        uint32_t first = static_cast<uint32_t>(node - numBlocks_) * kLeaf;
+        for (uint32_t bin = first; bin < first + kLeaf; ++bin)
+        {
+            if (residual_[bin] >= size)
+            {
+                return bin;
+            }
+        }
+        return UINT32_MAX;
+    }
+
+    uint32_t openBin(uint32_t capacity)
+    {
+        if (numBins_ == numBlocks_ * kLeaf)
+        {
+            grow();
+        }
+        residual_[numBins_] = capacity;
+        update(numBins_);
+        return numBins_++;
+    }
+
+    void addItem(uint32_t bin, uint32_t size)
+    {
+        residual_[bin] -= size;
+        update(bin);
+    }
+
+    // Closes every bin and keeps the arrays for the next packing.
+    void clear()
+    {
+        std::fill(residual_.begin(), residual_.end(), 0);
+        std::fill(tree_.begin(), tree_.end(), 0);
+        numBins_ = 0;
+    }
+
+private:
+    void update(uint32_t bin)
+    {
+        uint32_t block = bin / kLeaf;
+        uint32_t best = 0;
+        for (uint32_t b = block * kLeaf; b < (block + 1) * kLeaf; ++b)
+        {
+            best = std::max(best, residual_[b]);
+        }
+        size_t node = numBlocks_ + block;
+        tree_[node] = best;
+        for (node /= 2; node >= 1; node /= 2)
+        {
+            tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+        }
+    }
+
+    void grow()
+    {
+        size_t blocks = numBlocks_ == 0 ? 1024 : numBlocks_ * 2;
+        residual_.resize(blocks * kLeaf, 0);
+        tree_.assign(2 * blocks, 0);
+        numBlocks_ = blocks;
+        for (size_t block = 0; block < blocks; ++block)
+        {
+            uint32_t best = 0;
+            for (size_t b = block * kLeaf; b < (block + 1) * kLeaf; ++b)
+            {
+                best = std::max(best, residual_[b]);
+            }
+            tree_[blocks + block] = best;
+        }
+        for (size_t node = blocks - 1; node >= 1; --node)
+        {
+            tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+        }
+    }
+
+    std::pmr::vector<uint32_t> residual_;
+    std::pmr::vector<uint32_t> tree_;
+    uint32_t numBins_;
+    size_t numBlocks_;
+};
+
+// Best fit index: bins bucketed by residual. Every bucket is an intrusive stack
+// (head per residual, next per bin) and a two-level bitset over residuals finds the
+// smallest non-empty residual >= size.
+class BestFitBuckets
+{
+public:
+    // Largest capacity for which the buckets are used, 2^24 needs about 68 MB.
+    static constexpr uint32_t kMaxCapacity = 1u << 24;
+
+    BestFitBuckets(uint32_t capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity), head_(static_cast<size_t>(capacity) + 1, UINT32_MAX, resource),
+          level0_((static_cast<size_t>(capacity) + 64) / 64, 0, resource), level1_((level0_.size() + 63) / 64, 0, resource),
+          residual_(resource), next_(resource) {}
+
+    uint32_t getNumBins() const { return static_cast<uint32_t>(residual_.size()); }
+    const std::pmr::vector<uint32_t>& getResiduals() const { return residual_; }
+
+    uint32_t findBin(uint32_t size) const
+    {
+        size_t r = nextNonEmpty(size);
+        return r == SIZE_MAX ? UINT32_MAX : head_[r];
+    }
+
+    uint32_t openBin()
+    {
+        uint32_t bin = static_cast<uint32_t>(residual_.size());
+        residual_.push_back(capacity_);
+        next_.push_back(UINT32_MAX);
+        push(bin);
+        return bin;
+    }
+
+    // The bin must be the head of its bucket, as returned by findBin.
+    void addItem(uint32_t bin, uint32_t size)
+    {
+        uint32_t r = residual_[bin];
+        head_[r] = next_[bin];
+        if (head_[r] == UINT32_MAX)
+        {
+            level0_[r / 64] &= ~(uint64_t(1) << (r % 64));
+            if (level0_[r / 64] == 0)
+            {
+                level1_[r / 4096] &= ~(uint64_t(1) << ((r / 64) % 64));
+            }
+        }
+        residual_[bin] = r - size;
+        push(bin);
+    }
+
+    // Closes every bin and keeps the arrays for the next packing.
+    void clear()
+    {
+        for (uint32_t r : residual_)
+        {
+            head_[r] = UINT32_MAX;
+            level0_[r / 64] = 0;
+            level1_[r / 4096] = 0;
+        }
+        residual_.clear();
+        next_.clear();
+    }
+
+private:
+    void push(uint32_t bin)
+    {
+        uint32_t r = residual_[bin];
+        next_[bin] = head_[r];
+        head_[r] = bin;
+        level0_[r / 64] |= uint64_t(1) << (r % 64);
+        level1_[r / 4096] |= uint64_t(1) << ((r / 64) % 64);
+    }
+
+    size_t nextNonEmpty(size_t r) const
+    {
+        if (r > capacity_)
+        {
+            return SIZE_MAX;
+        }
+        size_t word = r / 64;
+        uint64_t bits = level0_[word] & (~uint64_t(0) << (r % 64));
+        if (bits != 0)
+        {
+            return word * 64 + __builtin_ctzll(bits);
+        }
+        // Next non-empty level-0 word through the summary level.
+        size_t summary = (word + 1) / 64;
+        if (summary >= level1_.size())
+        {
+            return SIZE_MAX;
+        }
+        uint64_t mask = (word + 1) % 64 == 0 ? ~uint64_t(0) : (~uint64_t(0) << ((word + 1) % 64));
+        for (uint64_t summaryBits = level1_[summary] & mask; ; summaryBits = level1_[summary])
+        {
+            if (summaryBits != 0)
+            {
+                size_t w = summary * 64 + __builtin_ctzll(summaryBits);
+                return w * 64 + __builtin_ctzll(level0_[w]);
+            }
+            if (++summary >= level1_.size())
+            {
+                return SIZE_MAX;
+            }
+        }
+    }
+
+    uint32_t capacity_;
+    std::pmr::vector<uint32_t> head_;
+    std::pmr::vector<uint64_t> level0_;
+    std::pmr::vector<uint64_t> level1_;
+    std::pmr::vector<uint32_t> residual_;
+    std::pmr::vector<uint32_t> next_;
+};
+
+// Best fit index for capacities above BestFitBuckets::kMaxCapacity: the bins in a set
+// ordered by residual, so memory grows with the bins rather than the capacity. A bin
+// whose residual changes is extracted and reinserted, which reuses its node.
+class BestFitSet
+{
+public:
+    BestFitSet(uint32_t capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : capacity_(capacity), residual_(resource), bins_(resource) {}
+
+    uint32_t getNumBins() const { return static_cast<uint32_t>(residual_.size()); }
+    const std::pmr::vector<uint32_t>& getResiduals() const { return residual_; }
+
+    uint32_t findBin(uint32_t size) const
+    {
+        auto it = bins_.lower_bound({ size, 0 });
+        return it == bins_.end() ? UINT32_MAX : it->second;
+    }
+
+    uint32_t openBin()
+    {
+        uint32_t bin = static_cast<uint32_t>(residual_.size());
+        residual_.push_back(capacity_);
+        bins_.insert({ capacity_, bin });
+        return bin;
+    }
+
+    void addItem(uint32_t bin, uint32_t size)
+    {
+        auto node = bins_.extract({ residual_[bin], bin });
+        residual_[bin] -= size;
+        node.value().first = residual_[bin];
+        bins_.insert(std::move(node));
+    }
+
+    // Closes every bin.
+    void clear()
+    {
+        residual_.clear();
+        bins_.clear();
+    }
+
+private:
+    uint32_t capacity_;
+    std::pmr::vector<uint32_t> residual_;
+    std::pmr::set<std::pair<uint32_t, uint32_t>> bins_;
+};
+
+// Packs the items in the given order, binOf[i] receives the bin of item i.
+template <typename Index>
+uint32_t packLarge(const LargeInstance& instance, const std::pmr::vector<uint32_t>& order, Index& index,
+    std::pmr::vector<uint32_t>& binOf)
+{
+    binOf.assign(instance.getNumItems(), 0);
+    for (uint32_t i : order)
+    {
+        uint32_t size = instance.sizes[i];
+        uint32_t bin = index.findBin(size);
+        if (bin == UINT32_MAX)
+        {
+            if constexpr (std::is_same<Index, FirstFitTree>::value)
+            {
+                bin = index.openBin(instance.capacity);
+            }
+            else
+            {
+                bin = index.openBin();
+            }
+        }
+        index.addItem(bin, size);
+        binOf[i] = bin;
+    }
+    return index.getNumBins();
+}
+
+// BFD through the residual buckets, or through the residual set above their capacity
+// limit. Returns the number of bins.
+uint32_t packBestFit(const LargeInstance& instance, const std::pmr::vector<uint32_t>& order, std::pmr::vector<uint32_t>& binOf,
+    std::pmr::memory_resource* resource)
+{
+    if (instance.capacity <= BestFitBuckets::kMaxCapacity)
+    {
+        BestFitBuckets index(instance.capacity, resource);
+        return packLarge(instance, order, index, binOf);
+    }
+    BestFitSet index(instance.capacity, resource);
+    return packLarge(instance, order, index, binOf);
+}
+
+// ---------------Local search-------------------
+//
+// Post-optimisation of a finished packing, whatever engine produced it: the construction
+// stage, or one read through --initial such as the --assignment output of a hybrid run
+// with --instance. The target is the least-filled bin: its items move to the fullest
+// other bin that can hold them and whatever is left is exchanged, one or two items at a
+// time, against one or two smaller items of another bin (1-1, 1-2, 2-1 and 2-2 moves).
+// Every accepted move makes the sum of squared bin loads grow, so the search cannot
+// cycle, and a target that runs empty is dropped. Loads are updated per move; the bins
+// sit in a set ordered by residual that answers the best-fit lookups and bounds the
+// exchange scan. The search ends at a local optimum, at the lower bound or when the time
+// budget is spent.
+class LocalSearch
+{
+public:
+    // Exchanges only consider pairs from bins with at most this many items.
+    static constexpr uint32_t kMaxPairItems = 32;
+
+    LocalSearch(const LargeInstance& instance, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : instance_(instance), pool_(resource), load_(resource), first_(resource), next_(resource), prev_(resource),
+          bins_(&pool_), order_(resource), targetGroups_(resource), binGroups_(resource), best_(resource),
+          freeItems_(resource), ruined_(resource), empties_(resource), random_(1), binOf_(nullptr), numBinIds_(0), numBins_(0) {}
+
+    // binOf holds a feasible packing into bins numbered below numBins. On return it holds
+    // the improved packing with the bins renumbered densely; the new bin count is returned.
+    // The budget runs from the call, so building the loads and the residual set uses part
+    // of it. That O(n log n) setup and the final renumbering are never cut short, though; on
+    // millions of items they alone take around 100 ms, so a smaller budget is exceeded.
+    uint32_t improve(std::pmr::vector<uint32_t>& binOf, uint32_t numBins, std::chrono::milliseconds budget)
+    {
+        auto deadline = std::chrono::steady_clock::now() + budget;
+        load(binOf, numBins);
+        descend(deadline);
+        return store();
+    }
+
+    // Ruin and recreate around the descent. Every iteration empties the least-filled bin
+    // and ruinBins - 1 random others, reinserts their items by best fit decreasing through
+    // the residual set, reopening emptied bins only when nothing fits, and runs the descent
+    // again. The result is kept unless it needs more bins, otherwise the last kept packing
+    // is restored. All buffers are sized up front and the set nodes come from the pool, so
+    // iterations do not allocate. The budget covers the setup as in improve.
+    uint32_t searchLarge(std::pmr::vector<uint32_t>& binOf, uint32_t numBins, std::chrono::milliseconds budget,
+        uint32_t ruinBins, uint64_t& iterations)
+    {
+        auto deadline = std::chrono::steady_clock::now() + budget;
+        load(binOf, numBins);
+        descend(deadline);
+        uint32_t n = instance_.getNumItems();
+        uint64_t lowerBound = instance_.lowerBound();
+        best_.assign(binOf_, binOf_ + n);
+        uint32_t bestBins = numBins_;
+        freeItems_.reserve(n);
+        ruined_.reserve(ruinBins);
+        iterations = 0;
+        while (bestBins > lowerBound && std::chrono::steady_clock::now() < deadline)
+        {
+            ruin(ruinBins);
+            recreate();
+            descend(deadline);
+            ++iterations;
+            if (numBins_ <= bestBins)
+            {
+                std::copy(binOf_, binOf_ + n, best_.begin());
+                bestBins = numBins_;
+            }
+            else
+            {
+                std::copy(best_.begin(), best_.end(), binOf_);
+                rebuild();
+            }
+        }
+        return store();
+    }
+
+private:
+    struct Group
+    {
+        uint64_t size;
+        uint32_t first;
+        uint32_t second;
+    };
+
+    void load(std::pmr::vector<uint32_t>& binOf, uint32_t numBins)
+    {
+        binOf_ = binOf.data();
+        numBinIds_ = numBins;
+        empties_.reserve(numBins);
+        rebuild();
+    }
+
+    // Builds loads, item lists and the residual set from binOf_.
+    void rebuild()
+    {
+        uint32_t n = instance_.getNumItems();
+        load_.assign(numBinIds_, 0);
+        first_.assign(numBinIds_, UINT32_MAX);
+        next_.assign(n, UINT32_MAX);
+        prev_.assign(n, UINT32_MAX);
+        bins_.clear();
+        empties_.clear();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            link(i, binOf_[i]);
+            load_[binOf_[i]] += instance_.sizes[i];
+        }
+        numBins_ = 0;
+        for (uint32_t bin = 0; bin < numBinIds_; ++bin)
+        {
+            if (first_[bin] != UINT32_MAX)
+            {
+                bins_.insert({ instance_.capacity - load_[bin], bin });
+                ++numBins_;
+            }
+            else
+            {
+                empties_.push_back(bin);
+            }
+        }
+    }
+
+    void descend(std::chrono::steady_clock::time_point deadline)
+    {
+        uint64_t lowerBound = instance_.lowerBound();
+        bool improved = true;
+        while (improved && numBins_ > lowerBound && std::chrono::steady_clock::now() < deadline)
+        {
+            improved = false;
+            // Targets from the least to the most filled bin.
+            order_.clear();
+            for (auto it = bins_.rbegin(); it != bins_.rend(); ++it)
+            {
+                order_.push_back(it->second);
+            }
+            for (uint32_t target : order_)
+            {
+                if (numBins_ <= lowerBound || std::chrono::steady_clock::now() >= deadline)
+                {
+                    break;
+                }
+                improved |= improveBin(target);
+            }
+        }
+    }
+
+    // Renumbers the remaining bins densely, in their old order, and returns their count.
+    uint32_t store()
+    {
+        std::pmr::vector<uint32_t>& newId = first_;
+        uint32_t count = 0;
+        for (uint32_t bin = 0; bin < numBinIds_; ++bin)
+        {
+            newId[bin] = first_[bin] != UINT32_MAX ? count++ : UINT32_MAX;
+        }
+        for (uint32_t i = 0; i < instance_.getNumItems(); ++i)
+        {
+            binOf_[i] = newId[binOf_[i]];
+        }
+        binOf_ = nullptr;
+        return numBins_;
+    }
+
+    void ruin(uint32_t ruinBins)
+    {
+        ruined_.clear();
+        ruined_.push_back(bins_.rbegin()->second);
+        std::uniform_int_distribution<uint32_t> pick(0, numBinIds_ - 1);
+        for (uint32_t attempt = 0; ruined_.size() < std::min(ruinBins, numBins_) && attempt < 4 * ruinBins; ++attempt)
+        {
+            uint32_t bin = pick(random_);
+            if (first_[bin] != UINT32_MAX && std::find(ruined_.begin(), ruined_.end(), bin) == ruined_.end())
+            {
+                ruined_.push_back(bin);
+            }
+        }
+        freeItems_.clear();
+        for (uint32_t bin : ruined_)
+        {
+            for (uint32_t item = first_[bin]; item != UINT32_MAX; item = next_[item])
+            {
+                freeItems_.push_back(item);
+            }
+            first_[bin] = UINT32_MAX;
+            bins_.erase({ instance_.capacity - load_[bin], bin });
+            load_[bin] = 0;
+            empties_.push_back(bin);
+            --numBins_;
+        }
+    }
+
+    // Best fit decreasing of the freed items through the residual set, not through
+    // BestFitBuckets or FirstFitTree. Those open bins at full capacity under new dense ids
+    // and cannot drop a bin, while here the bins are partly filled, keep the ids the
+    // descent works on and are reopened from empties_. Loading them into an index would
+    // take a pass over all bins per iteration, and the set has to follow every placement
+    // for the descent anyway.
+    void recreate()
+    {
+        std::sort(freeItems_.begin(), freeItems_.end(), [&](uint32_t a, uint32_t b) {
+            return instance_.sizes[a] > instance_.sizes[b];
+            });
+        for (uint32_t item : freeItems_)
+        {
+            uint32_t size = instance_.sizes[item];
+            auto it = bins_.lower_bound({ size, 0 });
+            uint32_t bin;
+            if (it != bins_.end())
+            {
+                bin = it->second;
+            }
+            else
+            {
+                bin = empties_.back();
+                empties_.pop_back();
+                bins_.insert({ instance_.capacity, bin });
+                ++numBins_;
+            }
+            link(item, bin);
+            setLoad(bin, load_[bin] + size);
+            binOf_[item] = bin;
+        }
+    }
+
+    bool improveBin(uint32_t target)
+    {
+        bool changed = false;
+        while (true)
+        {
+            changed |= moveOut(target);
+            if (first_[target] == UINT32_MAX)
+            {
+                bins_.erase({ instance_.capacity - load_[target], target });
+                empties_.push_back(target);
+                --numBins_;
+                return true;
+            }
+            if (!exchange(target))
+            {
+                return changed;
+            }
+            changed = true;
+        }
+    }
+
+    // Moves items of the target into the fullest other bin that can hold them, as long
+    // as that bin ends up fuller than the target was.
+    bool moveOut(uint32_t target)
+    {
+        bool moved = false;
+        for (uint32_t item = first_[target]; item != UINT32_MAX;)
+        {
+            uint32_t following = next_[item];
+            uint32_t size = instance_.sizes[item];
+            auto it = bins_.lower_bound({ size, 0 });
+            if (it != bins_.end() && it->second == target)
+            {
+                ++it;
+            }
+            if (it != bins_.end() && uint64_t(load_[it->second]) + size > load_[target])
+            {
+                moveItem(item, target, it->second);
+                moved = true;
+            }
+            item = following;
+        }
+        return moved;
+    }
+
+    // Applies the exchange between the target and another bin that raises the sum of
+    // squared loads the most. Scans the bins from the largest residual down and stops
+    // once the residual bounds the gain below the best exchange found.
+    bool exchange(uint32_t target)
+    {
+        collectGroups(target, targetGroups_);
+        uint64_t capacity = instance_.capacity;
+        uint64_t targetLoad = load_[target];
+        double bestGain = 0;
+        uint32_t bestBin = UINT32_MAX;
+        Group bestIn{};
+        Group bestOut{};
+        for (auto it = bins_.rbegin(); it != bins_.rend(); ++it)
+        {
+            uint64_t residual = it->first;
+            if (residual == 0 || 2.0 * residual * (capacity - targetLoad) <= bestGain)
+            {
+                break;
+            }
+            uint32_t bin = it->second;
+            if (bin == target)
+            {
+                continue;
+            }
+            uint64_t binLoad = load_[bin];
+            collectGroups(bin, binGroups_);
+            for (const Group& in : targetGroups_)
+            {
+                for (const Group& out : binGroups_)
+                {
+                    if (in.size <= out.size || in.size - out.size > residual)
+                    {
+                        continue;
+                    }
+                    uint64_t delta = in.size - out.size;
+                    if (binLoad + delta <= targetLoad)
+                    {
+                        continue;
+                    }
+                    double gain = 2.0 * delta * double(binLoad + delta - targetLoad);
+                    if (gain > bestGain)
+                    {
+                        bestGain = gain;
+                        bestBin = bin;
+                        bestIn = in;
+                        bestOut = out;
+                    }
+                }
+            }
+        }
+        if (bestBin == UINT32_MAX)
+        {
+            return false;
+        }
+        moveItem(bestOut.first, bestBin, target);
+        if (bestOut.second != UINT32_MAX)
+        {
+            moveItem(bestOut.second, bestBin, target);
+        }
+        moveItem(bestIn.first, target, bestBin);
+        if (bestIn.second != UINT32_MAX)
+        {
+            moveItem(bestIn.second, target, bestBin);
+        }
+        return true;
+    }
+
+    // Single items and, for bins with at most kMaxPairItems items, pairs of items.
+    void collectGroups(uint32_t bin, std::pmr::vector<Group>& groups) const
+    {
+        groups.clear();
+        for (uint32_t a = first_[bin]; a != UINT32_MAX; a = next_[a])
+        {
+            groups.push_back({ instance_.sizes[a], a, UINT32_MAX });
+        }
+        size_t singles = groups.size();
+        if (singles > kMaxPairItems)
+        {
+            return;
+        }
+        for (size_t a = 0; a < singles; ++a)
+        {
+            for (size_t b = a + 1; b < singles; ++b)
+            {
+                groups.push_back({ groups[a].size + groups[b].size, groups[a].first, groups[b].first });
+            }
+        }
+    }
+
+    void moveItem(uint32_t item, uint32_t from, uint32_t to)
+    {
+        uint32_t size = instance_.sizes[item];
+        unlink(item, from);
+        setLoad(from, load_[from] - size);
+        link(item, to);
+        setLoad(to, load_[to] + size);
+        binOf_[item] = to;
+    }
+
+    void setLoad(uint32_t bin, uint32_t load)
+    {
+        bins_.erase({ instance_.capacity - load_[bin], bin });
+        load_[bin] = load;
+        bins_.insert({ instance_.capacity - load, bin });
+    }
+
+    void link(uint32_t item, uint32_t bin)
+    {
+        prev_[item] = UINT32_MAX;
+        next_[item] = first_[bin];
+        if (first_[bin] != UINT32_MAX)
+        {
+            prev_[first_[bin]] = item;
+        }
+        first_[bin] = item;
+    }
+
+    void unlink(uint32_t item, uint32_t bin)
+    {
+        if (prev_[item] != UINT32_MAX)
+        {
+            next_[prev_[item]] = next_[item];
+        }
+        else
+        {
+            first_[bin] = next_[item];
+        }
+        if (next_[item] != UINT32_MAX)
+        {
+            prev_[next_[item]] = prev_[item];
+        }
+    }
+
+    const LargeInstance& instance_;
+    // The residual set churns on every move, so its nodes are recycled through a pool.
+    std::pmr::unsynchronized_pool_resource pool_;
+    std::pmr::vector<uint32_t> load_;
+    std::pmr::vector<uint32_t> first_;
+    std::pmr::vector<uint32_t> next_;
+    std::pmr::vector<uint32_t> prev_;
+    std::pmr::set<std::pair<uint32_t, uint32_t>> bins_;
+    std::pmr::vector<uint32_t> order_;
+    std::pmr::vector<Group> targetGroups_;
+    std::pmr::vector<Group> binGroups_;
+    std::pmr::vector<uint32_t> best_;
+    std::pmr::vector<uint32_t> freeItems_;
+    std::pmr::vector<uint32_t> ruined_;
+    std::pmr::vector<uint32_t> empties_;
+    std::mt19937 random_;
+    uint32_t* binOf_;
+    uint32_t numBinIds_;
+    uint32_t numBins_;
+};
+
+// ---------------Grouping genetic algorithm-------------------
+//
+// Falkenauer's grouping GA over whole packings. An individual is the bin of every item
+// and its fitness is Falkenauer's mean squared bin fill, which rewards fewer bins and,
+// for the same count, a mix of full and nearly empty bins. A child takes a run of bins
+// of one parent and the bins of the other parent that share no item with them, less a
+// few dropped as mutation. The items left over are put back in decreasing order through
+// the first fit or best fit index of the construction stage, and the local search
+// descent finishes the child. The population starts from the incumbent (the packing
+// of the earlier stages, or one read through --initial, such as the --assignment output
+// of a hybrid run with --instance), FFD, BFD and ruined copies of those. Every
+// generation breeds a full set of children in parallel, each thread with its own memory
+// pool and scratch buffers, and the best distinct packings of parents and children
+// survive. The search ends at the lower bound or the time limit.
+class GroupingGA
+{
+public:
+    // Random bins dropped from every child besides the least-filled one.
+    static constexpr uint32_t kMutations = 2;
+
+    GroupingGA(const LargeInstance& instance, uint32_t populationSize, uint32_t numThreads, std::chrono::milliseconds budget,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : instance_(instance), populationSize_(std::max(4u, populationSize)), numThreads_(std::max(1u, numThreads)),
+          budget_(budget), resource_(resource) {}
+
+    uint64_t getGenerations() const { return generations_; }
+
+    // binOf holds the incumbent packing into numBins bins. Returns the best bin count and
+    // leaves the best packing, with the bins numbered densely, in binOf.
+    uint32_t solve(std::pmr::vector<uint32_t>& binOf, uint32_t numBins)
+    {
+        auto deadline = std::chrono::steady_clock::now() + budget_;
+        uint64_t lowerBound = instance_.lowerBound();
+        generations_ = 0;
+        if (numBins <= lowerBound)
+        {
+            return numBins;
+        }
+        uint32_t n = instance_.getNumItems();
+        individuals_.clear();
+        individuals_.reserve(2 * populationSize_);
+        for (uint32_t k = 0; k < 2 * populationSize_; ++k)
+        {
+            individuals_.emplace_back(n, resource_);
+        }
+        workers_.clear();
+        for (uint32_t t = 0; t < numThreads_; ++t)
+        {
+            workers_.emplace_back(instance_, t + 1);
+        }
+        seed(binOf, numBins, deadline);
+
+        while (individuals_[population_[0]].numBins > lowerBound && std::chrono::steady_clock::now() < deadline)
+        {
+            forEachChild(populationSize_, [&](uint32_t c, Worker& worker)
+            {
+                Individual& child = individuals_[children_[c]];
+                child.fitness = -1;
+                if (std::chrono::steady_clock::now() < deadline)
+                {
+                    makeChild(tournament(worker.random), tournament(worker.random), kMutations, worker, child, deadline);
+                }
+            });
+            select();
+            ++generations_;
+        }
+
+        const Individual& best = individuals_[population_[0]];
+        std::copy(best.binOf.begin(), best.binOf.end(), binOf.begin());
+        return best.numBins;
+    }
+
+private:
+    struct Individual
+    {
+        Individual(uint32_t n, std::pmr::memory_resource* resource) : binOf(n, 0, resource) {}
+
+        std::pmr::vector<uint32_t> binOf;
+        uint32_t numBins = 0;
+        // Negative for a slot without a packing.
+        double fitness = -1;
+    };
+
+    // Everything a thread needs to breed children, allocated from its own pool.
+    struct Worker
+    {
+        Worker(const LargeInstance& instance, uint32_t seed)
+            : dropped(&pool), newId(&pool), load(&pool), childLoad(&pool), freeItems(&pool), firstFit(&pool),
+              bestFit(instance.capacity <= BestFitBuckets::kMaxCapacity ? instance.capacity : 0, &pool),
+              bestFitSet(instance.capacity, &pool), search(instance, &pool),
+              random(seed) {}
+
+        std::pmr::unsynchronized_pool_resource pool;
+        std::pmr::vector<char> dropped;
+        std::pmr::vector<uint32_t> newId;
+        std::pmr::vector<uint64_t> load;
+        std::pmr::vector<uint32_t> childLoad;
+        std::pmr::vector<uint32_t> freeItems;
+        FirstFitTree firstFit;
+        BestFitBuckets bestFit;
+        BestFitSet bestFitSet;
+        LocalSearch search;
+        std::mt19937 random;
+    };
+
+    // Slot 0 gets the incumbent, 1 and 2 FFD and BFD, the others ruined copies of these.
+    void seed(const std::pmr::vector<uint32_t>& binOf, uint32_t numBins, std::chrono::steady_clock::time_point deadline)
+    {
+        Worker& worker = workers_.front();
+        uint32_t seeds = 1;
+        Individual& incumbent = individuals_[0];
+        std::copy(binOf.begin(), binOf.end(), incumbent.binOf.begin());
+        incumbent.numBins = worker.search.improve(incumbent.binOf, numBins, remaining(deadline));
+        evaluate(incumbent, worker);
+
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return finishSeeds();
+        }
+        std::pmr::vector<uint32_t> order = decreasingOrder(instance_, &worker.pool);
+        worker.firstFit.clear();
+        individuals_[seeds].numBins = packLarge(instance_, order, worker.firstFit, individuals_[seeds].binOf);
+        evaluate(individuals_[seeds++], worker);
+        individuals_[seeds].numBins = packBestFit(instance_, order, individuals_[seeds].binOf, &worker.pool);
+        evaluate(individuals_[seeds++], worker);
+
+        forEachChild(populationSize_ - seeds, [&](uint32_t c, Worker& worker)
+        {
+            const Individual& parent = individuals_[c % seeds];
+            individuals_[seeds + c].fitness = -1;
+            if (std::chrono::steady_clock::now() < deadline)
+            {
+                makeChild(parent, parent, parent.numBins / 4, worker, individuals_[seeds + c], deadline);
+            }
+        });
+        finishSeeds();
+    }
+
+    void finishSeeds()
+    {
+        population_.clear();
+        children_.clear();
+        for (uint32_t k = 0; k < 2 * populationSize_; ++k)
+        {
+            (k < populationSize_ ? population_ : children_).push_back(k);
+        }
+        select();
+    }
+
+    // Runs f(c, worker) for c below count, spread over the threads.
+    template <typename F>
+    void forEachChild(uint32_t count, F f)
+    {
+        if (numThreads_ == 1)
+        {
+            for (uint32_t c = 0; c < count; ++c)
+            {
+                f(c, workers_.front());
+            }
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < numThreads_; ++t)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (uint32_t c = t; c < count; c += numThreads_)
+                {
+                    f(c, workers_[t]);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Crossover of a with a run of bins of b (none when a is b), minus the least-filled
+    // and mutations random bins of a; the child is then repaired and improved.
+    void makeChild(const Individual& a, const Individual& b, uint32_t mutations, Worker& worker, Individual& child,
+        std::chrono::steady_clock::time_point deadline)
+    {
+        uint32_t n = instance_.getNumItems();
+        uint32_t lo = 0;
+        uint32_t hi = 0;
+        if (&a != &b)
+        {
+            uint32_t length = std::uniform_int_distribution<uint32_t>(1, std::max(1u, b.numBins / 4))(worker.random);
+            lo = std::uniform_int_distribution<uint32_t>(0, b.numBins - length)(worker.random);
+            hi = lo + length;
+        }
+        worker.load.assign(a.numBins, 0);
+        worker.dropped.assign(a.numBins, 0);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            worker.load[a.binOf[i]] += instance_.sizes[i];
+            if (b.binOf[i] >= lo && b.binOf[i] < hi)
+            {
+                worker.dropped[a.binOf[i]] = 1;
+            }
+        }
+        std::uniform_int_distribution<uint32_t> pick(0, a.numBins - 1);
+        for (uint32_t m = 0; m < mutations; ++m)
+        {
+            worker.dropped[pick(worker.random)] = 1;
+        }
+        uint32_t least = UINT32_MAX;
+        for (uint32_t bin = 0; bin < a.numBins; ++bin)
+        {
+            if (!worker.dropped[bin] && worker.load[bin] > 0 && (least == UINT32_MAX || worker.load[bin] < worker.load[least]))
+            {
+                least = bin;
+            }
+        }
+        if (least != UINT32_MAX)
+        {
+            worker.dropped[least] = 1;
+        }
+
+        // The section bins come first, then the kept bins of a.
+        uint32_t kept = hi - lo;
+        worker.newId.assign(a.numBins, UINT32_MAX);
+        for (uint32_t bin = 0; bin < a.numBins; ++bin)
+        {
+            if (!worker.dropped[bin] && worker.load[bin] > 0)
+            {
+                worker.newId[bin] = kept++;
+            }
+        }
+        worker.childLoad.assign(kept, 0);
+        worker.freeItems.clear();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            uint32_t bin = b.binOf[i] >= lo && b.binOf[i] < hi ? b.binOf[i] - lo : worker.newId[a.binOf[i]];
+            child.binOf[i] = bin;
+            if (bin == UINT32_MAX)
+            {
+                worker.freeItems.push_back(i);
+            }
+            else
+            {
+                worker.childLoad[bin] += instance_.sizes[i];
+            }
+        }
+
+        std::sort(worker.freeItems.begin(), worker.freeItems.end(), [&](uint32_t x, uint32_t y) {
+            return instance_.sizes[x] > instance_.sizes[y];
+            });
+        uint32_t numBins = 0;
+        if ((worker.random() & 1) == 0)
+        {
+            numBins = repair(worker.firstFit, worker, child);
+        }
+        else if (instance_.capacity <= BestFitBuckets::kMaxCapacity)
+        {
+            numBins = repair(worker.bestFit, worker, child);
+        }
+        else
+        {
+            numBins = repair(worker.bestFitSet, worker, child);
+        }
+        child.numBins = worker.search.improve(child.binOf, numBins, remaining(deadline));
+        evaluate(child, worker);
+    }
+
+    // Opens the child's bins in the index and inserts the free items.
+    template <typename Index>
+    uint32_t repair(Index& index, Worker& worker, Individual& child)
+    {
+        index.clear();
+        for (uint32_t load : worker.childLoad)
+        {
+            index.addItem(openBin(index), load);
+        }
+        for (uint32_t i : worker.freeItems)
+        {
+            uint32_t size = instance_.sizes[i];
+            uint32_t bin = index.findBin(size);
+            if (bin == UINT32_MAX)
+            {
+                bin = openBin(index);
+            }
+            index.addItem(bin, size);
+            child.binOf[i] = bin;
+        }
+        return index.getNumBins();
+    }
+
+    template <typename Index>
+    uint32_t openBin(Index& index)
+    {
+        if constexpr (std::is_same<Index, FirstFitTree>::value)
+        {
+            return index.openBin(instance_.capacity);
+        }
+        else
+        {
+            return index.openBin();
+        }
+    }
+
+    // Falkenauer's fitness: the mean over the bins of the squared fill.
+    void evaluate(Individual& individual, Worker& worker)
+    {
+        worker.load.assign(individual.numBins, 0);
+        for (uint32_t i = 0; i < instance_.getNumItems(); ++i)
+        {
+            worker.load[individual.binOf[i]] += instance_.sizes[i];
+        }
+        double sum = 0;
+        for (uint64_t load : worker.load)
+        {
+            double fill = double(load) / instance_.capacity;
+            sum += fill * fill;
+        }
+        individual.fitness = individual.numBins > 0 ? sum / individual.numBins : 1.0;
+    }
+
+    // The fitter of two random members of the population.
+    const Individual& tournament(std::mt19937& random) const
+    {
+        std::uniform_int_distribution<uint32_t> pick(0, populationSize_ - 1);
+        const Individual& x = individuals_[population_[pick(random)]];
+        const Individual& y = individuals_[population_[pick(random)]];
+        return x.fitness >= y.fitness ? x : y;
+    }
+
+    // Keeps the fittest distinct packings of parents and children, duplicates only when
+    // there are too few of those; the other slots take the next children.
+    void select()
+    {
+        std::vector<uint32_t> order(population_);
+        order.insert(order.end(), children_.begin(), children_.end());
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t x, uint32_t y) {
+            return individuals_[x].fitness > individuals_[y].fitness;
+            });
+        std::vector<char> chosen(order.size(), 0);
+        population_.clear();
+        for (size_t k = 0; k < order.size() && population_.size() < populationSize_; ++k)
+        {
+            const Individual& individual = individuals_[order[k]];
+            bool duplicate = !population_.empty() && individuals_[population_.back()].numBins == individual.numBins
+                && individuals_[population_.back()].fitness == individual.fitness;
+            if (individual.fitness >= 0 && !duplicate)
+            {
+                population_.push_back(order[k]);
+                chosen[k] = 1;
+            }
+        }
+        for (size_t k = 0; k < order.size() && population_.size() < populationSize_; ++k)
+        {
+            if (!chosen[k])
+            {
+                population_.push_back(order[k]);
+                chosen[k] = 1;
+            }
+        }
+        children_.clear();
+        for (size_t k = 0; k < order.size(); ++k)
+        {
+            if (!chosen[k])
+            {
+                children_.push_back(order[k]);
+            }
+        }
+    }
+
+    static std::chrono::milliseconds remaining(std::chrono::steady_clock::time_point deadline)
+    {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        return std::max(left, std::chrono::milliseconds(0));
+    }
+
+    const LargeInstance& instance_;
+    uint32_t populationSize_;
+    uint32_t numThreads_;
+    std::chrono::milliseconds budget_;
+    std::pmr::memory_resource* resource_;
+    uint64_t generations_ = 0;
+    std::vector<Individual> individuals_;
+    // Indices into individuals_, the population sorted by decreasing fitness.
+    std::vector<uint32_t> population_;
+    std::vector<uint32_t> children_;
+    std::deque<Worker> workers_;
+};
+
+// Martello-Toth lower bound L2 of items sorted by decreasing size. For every K up to
+// C / 2, items larger than C - K need a bin of their own, items in (C / 2, C - K] need
+// one each as well but leave room for items in [K, C / 2], and whatever of those does
+// not fit in that room needs further bins.
+uint64_t lowerBoundL2(const uint32_t* sizes, size_t count, uint32_t capacity, std::vector<uint64_t>& prefix)
+{
+    prefix.assign(count + 1, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        prefix[i + 1] = prefix[i] + sizes[i];
+    }
+    uint64_t c = capacity;
+    uint64_t best = (prefix[count] + c - 1) / c;
+    uint32_t half = capacity / 2;
+    // Items larger than C / 2 come first.
+    size_t large = std::lower_bound(sizes, sizes + count, half, std::greater<uint32_t>()) - sizes;
+    for (size_t i = large; i <= count; ++i)
+    {
+        if (i < count && i > large && sizes[i] == sizes[i - 1])
+        {
+            continue;
+        }
+        uint32_t k = i < count ? sizes[i] : 0;
+        size_t j1 = std::lower_bound(sizes, sizes + large, capacity - k, std::greater<uint32_t>()) - sizes;
+        size_t j3 = std::upper_bound(sizes + large, sizes + count, k, std::greater<uint32_t>()) - sizes;
+        uint64_t room = (large - j1) * c - (prefix[large] - prefix[j1]);
+        uint64_t rest = prefix[j3] - prefix[large];
+        uint64_t bound = large + (rest > room ? (rest - room + c - 1) / c : 0);
+        best = std::max(best, bound);
+    }
+    return best;
+}
+
+// ---------------Branch and bound-------------------
+//
+// Exact solver for small and medium instances in the spirit of Martello and Toth's MTP.
+// Items are assigned by decreasing size, each to one of the open bins or to a new one.
+// A node is pruned when L2 of its relaxation, open bins taken as items of their load
+// plus the unassigned items, reaches the incumbent. The relaxation packs exactly like
+// the node, so
+// the MTP reduction applies to it: the bins Reduction fixes plus L2 of the rest bound the
+// node as well, and when it fixes the next item with an open bin, or in a bin of its
+// own, the item goes only there. Otherwise it goes into the open bins it fits into,
+// fullest first, and then a new bin. When the lower bound, L2 at first, leaves less room
+// than the smallest item, a first pass as in Korf's bin completion looks only for a
+// packing into that many bins, a perfect one, and proves the bound one higher if it
+// searches its whole tree without finding it. That pass branches where the fewest
+// choices are: on the item with the fewest bins left to go into, or on the items that
+// can go into an open bin that takes at most two more. Bins that the item leaves with
+// room for exactly one of the items left come first there, then a new bin if two of
+// them fill it, and the pass restarts with shuffled candidates under a growing node
+// limit, as the triplet search of the vector packer does. Dominance: an item that fills an open bin
+// exactly goes only there, and of several bins with the same load only one is tried.
+// The incumbent is the best of the packing of the earlier stages, FFD through
+// FirstFitTree and BFD through packBestFit.
+//
+// The depth-first search is iterative with one frame per item. Every thread explores
+// subproblems from its own deque and steals from the others when it runs dry; a thread
+// that sees idle threads hands the untried siblings of its shallowest frame over to its
+// deque. The search stops at the node or time limit, or once the incumbent meets the
+// bound.
+class BranchAndBound
+{
+public:
+    BranchAndBound(const LargeInstance& instance, uint32_t numThreads, uint64_t nodeLimit, std::chrono::milliseconds budget)
+        : instance_(instance), numThreads_(std::max(1u, numThreads)), nodeLimit_(nodeLimit), budget_(budget) {}
+
+    // L2, or the known bound, raised by a search that finishes without a better packing.
+    uint64_t getLowerBound() const { return lowerBound_; }
+    uint64_t getNodes() const { return nodes_; }
+
+    // A lower bound known from elsewhere, such as the arc-flow LP. It replaces L2 as the
+    // target when it is higher.
+    void setLowerBound(uint64_t bound) { knownBound_ = bound; }
+
+    // binOf holds the incumbent packing into numBins bins. Returns the best bin count and
+    // leaves the best packing in binOf; proven tells whether it is optimal.
+    uint32_t solve(std::pmr::vector<uint32_t>& binOf, uint32_t numBins, bool& proven)
+    {
+        uint32_t n = instance_.getNumItems();
+        order_ = decreasingOrder(instance_, std::pmr::get_default_resource());
+        sizes_.resize(n);
+        for (uint32_t j = 0; j < n; ++j)
+        {
+            sizes_[j] = instance_.sizes[order_[j]];
+        }
+        std::vector<uint64_t> prefix;
+        lowerBound_ = std::max(knownBound_, lowerBoundL2(sizes_.data(), n, instance_.capacity, prefix));
+        if (numBins > lowerBound_)
+        {
+            seed(binOf, numBins);
+        }
+        bestBins_ = numBins;
+        improved_ = false;
+        proven = numBins <= lowerBound_;
+        if (proven)
+        {
+            return numBins;
+        }
+
+        // Fewer than numBins bins are open at any node, so that many candidates at most.
+        slice_ = numBins;
+        deadline_ = std::chrono::steady_clock::now() + budget_;
+        stop_ = false;
+        limitHit_ = false;
+        nodes_ = 0;
+        uint64_t total = std::accumulate(sizes_.begin(), sizes_.end(), uint64_t(0));
+        uint64_t runNodes = n;
+        round_ = 0;
+        // A tight pass, one whose bound leaves less room than the smallest item, looks
+        // only for a packing into lowerBound_ bins and restarts under a node limit that
+        // grows by half each time; a run that finishes raises the bound by one. Any other
+        // pass looks for packings better than the incumbent and finishes the search.
+        while (!stop_ && lowerBound_ < bestBins_)
+        {
+            tight_ = lowerBound_ * instance_.capacity - total < sizes_.back();
+            cut_ = tight_ ? static_cast<uint32_t>(lowerBound_) + 1 : bestBins_.load();
+            runLimit_ = tight_ ? nodes_ + runNodes : 0;
+            restart_ = false;
+            idle_ = 0;
+            workers_ = std::vector<Worker>(numThreads_);
+            workers_[0].queue.push_back(Subproblem{ 0, {}, {}, {} });
+            pending_ = 1;
+            std::vector<std::thread> threads;
+            for (uint32_t t = 1; t < numThreads_; ++t)
+            {
+                threads.emplace_back(&BranchAndBound::run, this, t);
+            }
+            run(0);
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            if (restart_ && !limitHit_)
+            {
+                stop_ = false;
+                runNodes += runNodes / 2;
+                ++round_;
+            }
+            else if (!stop_)
+            {
+                lowerBound_ = tight_ ? lowerBound_ + 1 : bestBins_.load();
+                runNodes = n;
+                round_ = 0;
+            }
+        }
+
+        proven = bestBins_ <= lowerBound_;
+        if (improved_)
+        {
+            for (uint32_t j = 0; j < n; ++j)
+            {
+                binOf[order_[j]] = bestAssign_[j];
+            }
+        }
+        return bestBins_;
+    }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr uint64_t kCheckInterval = 1024;
+
+    // A node to explore: its depth, the bin loads and the items placed so far with
+    // their bins.
+    struct Subproblem
+    {
+        uint32_t depth;
+        std::vector<uint32_t> loads;
+        std::vector<uint32_t> assign;
+        std::vector<uint32_t> items;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Subproblem> queue;
+    };
+
+    // Search state of one thread. counts[b] is the number of items in bin b. items[d] is
+    // the position in sizes_ of the item placed at depth d and assign[d] its bin. The
+    // candidate bins at depth d are candidates[d * slice_] onwards, next[d] is the next
+    // one to try. left holds the sizes of the unplaced items by decreasing size and
+    // leftItems their positions. slack is the room the target leaves at the node beyond
+    // the items and the room no item fits into, pairMin and tripleMin the least two and
+    // three of the items left fill. target[d] is the bin a frame fills. relaxed
+    // holds the relaxation of the node by decreasing size, fromBin[i] tells whether entry
+    // i is an open bin, and forced is the load of the bins the largest unplaced item is
+    // fixed with by the reduction, 0 for a bin of its own and kNone if it is not fixed.
+    struct State
+    {
+        std::vector<uint32_t> loads;
+        std::vector<uint32_t> counts;
+        std::vector<uint32_t> assign;
+        std::vector<uint32_t> items;
+        std::vector<char> placed;
+        std::vector<uint32_t> left;
+        std::vector<uint32_t> leftItems;
+        std::vector<uint32_t> target;
+        std::vector<uint32_t> next;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> numCandidates;
+        std::vector<uint32_t> openLoads;
+        std::vector<uint32_t> exact;
+        LargeInstance relaxed;
+        std::vector<char> fromBin;
+        Reduction reduction{ relaxed };
+        std::pmr::vector<uint32_t> fixedOf;
+        LargeInstance rest;
+        std::pmr::vector<uint32_t> restItems;
+        std::vector<uint64_t> prefix;
+        uint64_t slack = 0;
+        uint64_t pairMin = UINT64_MAX;
+        uint64_t tripleMin = UINT64_MAX;
+        uint32_t forced = kNone;
+        uint32_t numOpen = 0;
+        std::mt19937 random;
+    };
+
+    void run(uint32_t t)
+    {
+        uint32_t n = instance_.getNumItems();
+        State state;
+        state.loads.assign(n, 0);
+        state.counts.assign(n, 0);
+        state.assign.assign(n, 0);
+        state.items.assign(n, 0);
+        state.placed.assign(n, 0);
+        state.target.assign(n, kNone);
+        state.next.assign(n, 0);
+        state.candidates.resize(size_t(n) * slice_);
+        state.numCandidates.assign(n, 0);
+        state.random.seed(round_ * numThreads_ + t);
+        bool idle = false;
+        while (!stop_)
+        {
+            Subproblem sub;
+            if (take(t, sub))
+            {
+                if (idle)
+                {
+                    --idle_;
+                    idle = false;
+                }
+                explore(t, sub, state);
+                --pending_;
+            }
+            else if (pending_ == 0)
+            {
+                break;
+            }
+            else
+            {
+                if (!idle)
+                {
+                    ++idle_;
+                    idle = true;
+                }
+                std::this_thread::yield();
+            }
+        }
+        if (idle)
+        {
+            --idle_;
+        }
+    }
+
+    // Replaces the incumbent by the FFD or BFD packing when that needs fewer bins.
+    void seed(std::pmr::vector<uint32_t>& binOf, uint32_t& numBins) const
+    {
+        std::pmr::memory_resource* resource = binOf.get_allocator().resource();
+        std::pmr::vector<uint32_t> candidate(resource);
+        FirstFitTree firstFit(resource);
+        uint32_t bins = packLarge(instance_, order_, firstFit, candidate);
+        if (bins < numBins)
+        {
+            binOf.assign(candidate.begin(), candidate.end());
+            numBins = bins;
+        }
+        bins = packBestFit(instance_, order_, candidate, resource);
+        if (bins < numBins)
+        {
+            binOf.assign(candidate.begin(), candidate.end());
+            numBins = bins;
+        }
+    }
+
+    // Own deque from the back, the others' from the front.
+    bool take(uint32_t t, Subproblem& sub)
+    {
+        for (uint32_t k = 0; k < numThreads_; ++k)
+        {
+            Worker& worker = workers_[(t + k) % numThreads_];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (!worker.queue.empty())
+            {
+                if (k == 0)
+                {
+                    sub = std::move(worker.queue.back());
+                    worker.queue.pop_back();
+                }
+                else
+                {
+                    sub = std::move(worker.queue.front());
+                    worker.queue.pop_front();
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void explore(uint32_t t, const Subproblem& sub, State& state)
+    {
+        uint32_t n = instance_.getNumItems();
+        uint32_t base = sub.depth;
+        state.numOpen = static_cast<uint32_t>(sub.loads.size());
+        std::copy(sub.loads.begin(), sub.loads.end(), state.loads.begin());
+        // Bins of the subproblem are never emptied below it, any nonzero count will do.
+        std::fill(state.counts.begin(), state.counts.begin() + state.numOpen, 1);
+        std::copy(sub.assign.begin(), sub.assign.end(), state.assign.begin());
+        std::copy(sub.items.begin(), sub.items.end(), state.items.begin());
+        std::fill(state.placed.begin(), state.placed.end(), 0);
+        for (uint32_t item : sub.items)
+        {
+            state.placed[item] = 1;
+        }
+        uint32_t d = base;
+        bool entering = true;
+        uint64_t localNodes = 0;
+        while (true)
+        {
+            if (entering)
+            {
+                entering = false;
+                if (++localNodes % kCheckInterval == 0 && !checkLimits(t, d, base, state))
+                {
+                    return;
+                }
+                bool prune = true;
+                if (d == n)
+                {
+                    record(state);
+                }
+                else
+                {
+                    prune = bound(d, state) >= cut_;
+                }
+                if (!prune)
+                {
+                    collectCandidates(d, state);
+                }
+                else if (d == base)
+                {
+                    break;
+                }
+                else
+                {
+                    unplace(--d, state);
+                }
+            }
+            uint32_t choice = nextCandidate(d, state);
+            if (choice != kNone)
+            {
+                place(d++, choice, state);
+                entering = true;
+            }
+            else if (d == base)
+            {
+                break;
+            }
+            else
+            {
+                unplace(--d, state);
+            }
+        }
+        nodes_ += localNodes % kCheckInterval;
+    }
+
+    // Picks the item to place at depth d and its candidate bins. The item is the largest
+    // left, or in a tight pass the one chooseItem picks. Its candidates are the bin the
+    // reduction fixes it with or the bin it fills exactly if there is one, otherwise
+    // every open bin it fits into and leaves viable, one per load and fullest first, and
+    // then a new bin. In a tight pass the bins it leaves with room for exactly one of the
+    // items left come first, and the new bin right after them if two items fill it.
+    void collectCandidates(uint32_t d, State& state) const
+    {
+        uint32_t* candidates = state.candidates.data() + size_t(d) * slice_;
+        uint32_t count = 0;
+        state.next[d] = 0;
+        state.target[d] = kNone;
+        uint32_t pick = 0;
+        if (state.forced == kNone && tight_)
+        {
+            pick = chooseItem(d, state);
+            if (pick == kNone)
+            {
+                return;
+            }
+        }
+        state.items[d] = state.leftItems[pick];
+        uint32_t size = state.left[pick];
+        if (state.forced != kNone)
+        {
+            for (uint32_t b = 0; b < state.numOpen && state.forced != 0; ++b)
+            {
+                if (state.loads[b] == state.forced)
+                {
+                    candidates[count++] = b;
+                    break;
+                }
+            }
+            if (state.forced == 0 && state.numOpen + 1 < cut_)
+            {
+                candidates[count++] = state.numOpen;
+            }
+            state.numCandidates[d] = count;
+            return;
+        }
+        for (uint32_t b = 0; b < state.numOpen; ++b)
+        {
+            uint32_t load = state.loads[b] + size;
+            if (load == instance_.capacity)
+            {
+                candidates[0] = b;
+                count = 1;
+                state.numCandidates[d] = count;
+                return;
+            }
+            if (load < instance_.capacity && viable(state, instance_.capacity - load, pick))
+            {
+                candidates[count++] = b;
+            }
+        }
+        std::sort(candidates, candidates + count, [&](uint32_t a, uint32_t b) {
+            return state.loads[a] != state.loads[b] ? state.loads[a] > state.loads[b] : a < b;
+            });
+        count = static_cast<uint32_t>(std::unique(candidates, candidates + count, [&](uint32_t a, uint32_t b) {
+            return state.loads[a] == state.loads[b];
+            }) - candidates);
+        uint32_t* completed = candidates + count;
+        if (tight_)
+        {
+            completed = std::stable_partition(candidates, candidates + count, [&](uint32_t b) {
+                return hasSize(state.left, instance_.capacity - state.loads[b] - size, pick);
+                });
+        }
+        if (round_ > 0)
+        {
+            std::shuffle(candidates, completed, state.random);
+            std::shuffle(completed, candidates + count, state.random);
+        }
+        if (state.numOpen + 1 < cut_ && viable(state, instance_.capacity - size, pick))
+        {
+            // A new bin comes right after those when two of the items left fill it exactly.
+            if (tight_ && fillsWithPair(state.left, instance_.capacity - size, pick))
+            {
+                std::copy_backward(completed, candidates + count, candidates + count + 1);
+                *completed = state.numOpen;
+            }
+            else
+            {
+                candidates[count] = state.numOpen;
+            }
+            ++count;
+        }
+        state.numCandidates[d] = count;
+    }
+
+    // The position in left of the item with the fewest bins to go into, counting one per
+    // load and a bin that it fills exactly as the only one; on ties the largest, or after
+    // a restart one at random. When an open bin that takes at most two more items has no
+    // more items left to go into it, the candidates at depth d become those items instead
+    // and kNone is returned.
+    uint32_t chooseItem(uint32_t d, State& state) const
+    {
+        uint32_t c = instance_.capacity;
+        const std::vector<uint32_t>& left = state.left;
+        std::vector<uint32_t>& loads = state.openLoads;
+        loads.erase(std::unique(loads.begin(), loads.end()), loads.end());
+        uint32_t best = 0;
+        uint32_t fewest = kNone;
+        for (uint32_t i = 0; i < left.size() && fewest > 0; ++i)
+        {
+            uint32_t size = left[i];
+            if (i > 0 && size == left[i - 1])
+            {
+                continue;
+            }
+            uint32_t count = state.numOpen + 1 < cut_ && viable(state, c - size, i) ? 1 : 0;
+            for (uint32_t load : loads)
+            {
+                if (load + size == c)
+                {
+                    count = 1;
+                    break;
+                }
+                if (load + size < c && viable(state, c - load - size, i) && ++count >= fewest)
+                {
+                    break;
+                }
+            }
+            if (count < fewest || (count == fewest && round_ > 0 && state.random() % 2 == 0))
+            {
+                fewest = count;
+                best = i;
+            }
+        }
+
+        uint32_t bestBin = kNone;
+        for (uint32_t b = 0; b < state.numOpen && fewest > 0; ++b)
+        {
+            // Room that no item fits into is out of the slack already.
+            uint32_t room = c - state.loads[b];
+            if (room <= state.slack || room < left.back() || room >= state.tripleMin)
+            {
+                continue;
+            }
+            uint32_t count = 0;
+            size_t i = std::lower_bound(left.begin(), left.end(), room, std::greater<uint32_t>()) - left.begin();
+            for (; i < left.size() && count <= fewest; ++i)
+            {
+                count += (i == 0 || left[i] != left[i - 1]) && fillsBin(state, room, static_cast<uint32_t>(i));
+            }
+            if (count <= fewest)
+            {
+                fewest = count;
+                bestBin = b;
+            }
+        }
+        if (bestBin == kNone)
+        {
+            return best;
+        }
+        uint32_t* candidates = state.candidates.data() + size_t(d) * slice_;
+        uint32_t room = c - state.loads[bestBin];
+        uint32_t count = 0;
+        size_t i = std::lower_bound(left.begin(), left.end(), room, std::greater<uint32_t>()) - left.begin();
+        for (; i < left.size(); ++i)
+        {
+            if ((i == 0 || left[i] != left[i - 1]) && fillsBin(state, room, static_cast<uint32_t>(i)))
+            {
+                candidates[count++] = state.leftItems[i];
+            }
+        }
+        if (round_ > 0)
+        {
+            std::shuffle(candidates, candidates + count, state.random);
+        }
+        state.target[d] = bestBin;
+        state.numCandidates[d] = count;
+        return kNone;
+    }
+
+    // Whether the item at position i of left, as the larger of at most two more items,
+    // leaves a bin with room left no more than the slack short of full.
+    bool fillsBin(const State& state, uint32_t room, uint32_t i) const
+    {
+        const std::vector<uint32_t>& left = state.left;
+        uint32_t rest = room - left[i];
+        if (rest <= state.slack)
+        {
+            return true;
+        }
+        uint32_t cap = std::min(rest, left[i]);
+        size_t k = std::lower_bound(left.begin(), left.end(), cap, std::greater<uint32_t>()) - left.begin();
+        k += k == i;
+        return k < left.size() && left[k] + state.slack >= rest;
+    }
+
+    // Whether a bin with room left can still be filled up to the slack of the node: the
+    // slack covers the room, one of the items left other than the one at skip fills it
+    // that far, or two of them fit.
+    bool viable(const State& state, uint64_t room, uint32_t skip) const
+    {
+        if (room <= state.slack || room >= state.pairMin)
+        {
+            return true;
+        }
+        const std::vector<uint32_t>& left = state.left;
+        size_t i = std::lower_bound(left.begin(), left.end(), room, std::greater<uint64_t>()) - left.begin();
+        i += i == skip;
+        return i < left.size() && left[i] + state.slack >= room;
+    }
+
+    // Whether one of the sizes in left other than the one at skip equals room.
+    static bool hasSize(const std::vector<uint32_t>& left, uint32_t room, uint32_t skip)
+    {
+        auto range = std::equal_range(left.begin(), left.end(), room, std::greater<uint32_t>());
+        return static_cast<size_t>(range.second - range.first) > (left[skip] == room ? 1u : 0u);
+    }
+
+    // The largest size of one item or of two items of left that fits into room. Only
+    // kMaxPairScan sizes are tried for the larger of two; past that the whole room counts
+    // as filled.
+    static uint32_t bestFill(const std::vector<uint32_t>& left, uint32_t room)
+    {
+        uint32_t n = static_cast<uint32_t>(left.size());
+        uint32_t a = static_cast<uint32_t>(std::lower_bound(left.begin(), left.end(), room, std::greater<uint32_t>()) - left.begin());
+        if (a == n)
+        {
+            return 0;
+        }
+        uint32_t best = left[a];
+        for (uint32_t scanned = 0; a + 1 < n && best < room && left[a] + left[a + 1] > best; ++a)
+        {
+            if (a > 0 && left[a] == left[a - 1] && scanned > 0)
+            {
+                continue;
+            }
+            if (++scanned > Reduction::kMaxPairScan)
+            {
+                return room;
+            }
+            uint32_t b = static_cast<uint32_t>(std::lower_bound(left.begin() + a + 1, left.end(), room - left[a], std::greater<uint32_t>()) - left.begin());
+            if (b < n)
+            {
+                best = std::max(best, left[a] + left[b]);
+            }
+        }
+        return best;
+    }
+
+    // Whether two of the sizes in left other than the one at skip sum to room.
+    static bool fillsWithPair(const std::vector<uint32_t>& left, uint32_t room, uint32_t skip)
+    {
+        if (left.size() < 3)
+        {
+            return false;
+        }
+        size_t a = skip == 0 ? 1 : 0;
+        size_t b = left.size() - (skip + 1 == left.size() ? 2 : 1);
+        while (a < b)
+        {
+            uint32_t sum = left[a] + left[b];
+            if (sum == room)
+            {
+                return true;
+            }
+            if (sum > room)
+            {
+                a += a + 1 == skip ? 2 : 1;
+            }
+            else
+            {
+                b -= b - 1 == skip ? 2 : 1;
+            }
+        }
+        return false;
+    }
+
+    uint32_t nextCandidate(uint32_t d, State& state) const
+    {
+        if (state.next[d] == state.numCandidates[d])
+        {
+            return kNone;
+        }
+        return state.candidates[size_t(d) * slice_ + state.next[d]++];
+    }
+
+    // Places the item at depth d: choice is its bin, or the item itself when the frame
+    // fills a given bin.
+    void place(uint32_t d, uint32_t choice, State& state) const
+    {
+        uint32_t bin = choice;
+        if (state.target[d] != kNone)
+        {
+            state.items[d] = choice;
+            bin = state.target[d];
+        }
+        if (bin == state.numOpen)
+        {
+            state.loads[state.numOpen] = 0;
+            state.counts[state.numOpen++] = 0;
+        }
+        state.loads[bin] += sizes_[state.items[d]];
+        ++state.counts[bin];
+        state.assign[d] = bin;
+        state.placed[state.items[d]] = 1;
+    }
+
+    void unplace(uint32_t d, State& state) const
+    {
+        uint32_t bin = state.assign[d];
+        state.loads[bin] -= sizes_[state.items[d]];
+        state.placed[state.items[d]] = 0;
+        if (--state.counts[bin] == 0 && bin + 1 == state.numOpen)
+        {
+            --state.numOpen;
+        }
+    }
+
+    // Collects the items left, then L1 with waste: the room no remaining item fits into,
+    // and where at most two of them fit the room that the best one or two leave. Bins
+    // that only one more item fits into and that an item size fills exactly waste at
+    // least 1 each beyond the number of items of that size. Then L2 of the relaxation and
+    // then the reduction of the relaxation, each if the previous bound does not prune
+    // already. The slack is what the target leaves beyond the items and the room no item
+    // fits into; the other waste is left out, as it belongs to bins that are candidates.
+    uint64_t bound(uint32_t d, State& state) const
+    {
+        uint32_t n = instance_.getNumItems();
+        uint64_t c = instance_.capacity;
+        state.forced = kNone;
+        std::vector<uint32_t>& left = state.left;
+        left.clear();
+        state.leftItems.clear();
+        for (uint32_t j = 0; j < n; ++j)
+        {
+            if (!state.placed[j])
+            {
+                left.push_back(sizes_[j]);
+                state.leftItems.push_back(j);
+            }
+        }
+        size_t m = n - d;
+        uint64_t two = m >= 2 ? uint64_t(left[m - 1]) + left[m - 2] : UINT64_MAX;
+        uint64_t three = m >= 3 ? two + left[m - 3] : UINT64_MAX;
+        state.pairMin = m >= 3 ? two : UINT64_MAX;
+        state.tripleMin = three;
+        uint64_t total = 0;
+        uint64_t lost = 0;
+        uint64_t waste = 0;
+        state.exact.clear();
+        for (uint32_t b = 0; b < state.numOpen; ++b)
+        {
+            uint32_t room = instance_.capacity - state.loads[b];
+            total += state.loads[b];
+            if (room < left[m - 1])
+            {
+                lost += room;
+            }
+            else if (room < three)
+            {
+                uint32_t fill = bestFill(left, room);
+                waste += room - fill;
+                if (fill == room && room < two)
+                {
+                    state.exact.push_back(room);
+                }
+            }
+        }
+        std::sort(state.exact.begin(), state.exact.end(), std::greater<uint32_t>());
+        for (size_t i = 0; i < state.exact.size();)
+        {
+            size_t end = std::upper_bound(state.exact.begin() + i, state.exact.end(), state.exact[i], std::greater<uint32_t>()) - state.exact.begin();
+            auto items = std::equal_range(left.begin(), left.end(), state.exact[i], std::greater<uint32_t>());
+            size_t available = static_cast<size_t>(items.second - items.first);
+            waste += end - i > available ? end - i - available : 0;
+            i = end;
+        }
+        for (uint32_t size : left)
+        {
+            total += size;
+        }
+        uint64_t result = std::max<uint64_t>(state.numOpen, (total + lost + waste + c - 1) / c);
+        if (result >= cut_)
+        {
+            return result;
+        }
+        state.slack = (cut_ - 1) * c - total - lost;
+        // Merge the open bins by decreasing load with the items left, bins first on ties.
+        state.openLoads.assign(state.loads.begin(), state.loads.begin() + state.numOpen);
+        std::sort(state.openLoads.begin(), state.openLoads.end(), std::greater<uint32_t>());
+        std::pmr::vector<uint32_t>& relaxed = state.relaxed.sizes;
+        state.relaxed.capacity = instance_.capacity;
+        relaxed.clear();
+        state.fromBin.clear();
+        uint32_t first = kNone;
+        for (size_t b = 0, j = 0; b < state.numOpen || j < m;)
+        {
+            bool open = j == m || (b < state.numOpen && state.openLoads[b] >= left[j]);
+            if (!open && j == 0)
+            {
+                first = static_cast<uint32_t>(relaxed.size());
+            }
+            relaxed.push_back(open ? state.openLoads[b++] : left[j++]);
+            state.fromBin.push_back(open);
+        }
+        result = std::max(result, lowerBoundL2(relaxed.data(), relaxed.size(), instance_.capacity, state.prefix));
+        if (result >= cut_)
+        {
+            return result;
+        }
+
+        uint64_t fixed = state.reduction.reduce(state.fixedOf, state.rest, state.restItems);
+        result = std::max(result, fixed + lowerBoundL2(state.rest.sizes.data(), state.rest.sizes.size(), instance_.capacity, state.prefix));
+        uint32_t bin = state.fixedOf[first];
+        if (bin != UINT32_MAX)
+        {
+            state.forced = 0;
+            for (uint32_t i = 0; i < relaxed.size(); ++i)
+            {
+                if (i != first && state.fixedOf[i] == bin)
+                {
+                    state.forced = state.fromBin[i] ? relaxed[i] : 0;
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+
+    void record(const State& state)
+    {
+        std::lock_guard<std::mutex> lock(bestMutex_);
+        if (state.numOpen < bestBins_)
+        {
+            bestBins_ = state.numOpen;
+            cut_ = std::min(cut_.load(), state.numOpen);
+            bestAssign_.resize(state.assign.size());
+            for (uint32_t k = 0; k < state.assign.size(); ++k)
+            {
+                bestAssign_[state.items[k]] = state.assign[k];
+            }
+            improved_ = true;
+            if (bestBins_ <= lowerBound_)
+            {
+                stop_ = true;
+            }
+        }
+    }
+
+    // Counts nodes, stops the search at a limit and donates work to idle threads.
+    bool checkLimits(uint32_t t, uint32_t d, uint32_t base, State& state)
+    {
+        uint64_t nodes = nodes_ += kCheckInterval;
+        if ((nodeLimit_ != 0 && nodes >= nodeLimit_) || std::chrono::steady_clock::now() >= deadline_)
+        {
+            limitHit_ = true;
+            stop_ = true;
+        }
+        else if (runLimit_ != 0 && nodes >= runLimit_)
+        {
+            restart_ = true;
+            stop_ = true;
+        }
+        if (stop_)
+        {
+            return false;
+        }
+        if (idle_ > 0)
+        {
+            donate(t, d, base, state);
+        }
+        return true;
+    }
+
+    // Moves the untried candidates of the shallowest frame with any left into subproblems
+    // on the deque of thread t. The frames below are unwound to reach that node and then
+    // replayed.
+    void donate(uint32_t t, uint32_t d, uint32_t base, State& state)
+    {
+        Worker& worker = workers_[t];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (!worker.queue.empty())
+            {
+                return;
+            }
+        }
+        for (uint32_t dd = base; dd < d; ++dd)
+        {
+            std::vector<uint32_t> replay;
+            for (uint32_t j = dd; j < d; ++j)
+            {
+                replay.push_back(state.target[j] != kNone ? state.items[j] : state.assign[j]);
+            }
+            for (uint32_t j = d; j-- > dd;)
+            {
+                unplace(j, state);
+            }
+            uint32_t donated = 0;
+            for (uint32_t choice = nextCandidate(dd, state); choice != kNone; choice = nextCandidate(dd, state))
+            {
+                place(dd, choice, state);
+                Subproblem sub{ dd + 1, std::vector<uint32_t>(state.loads.begin(), state.loads.begin() + state.numOpen),
+                    std::vector<uint32_t>(state.assign.begin(), state.assign.begin() + dd + 1),
+                    std::vector<uint32_t>(state.items.begin(), state.items.begin() + dd + 1) };
+                unplace(dd, state);
+                ++pending_;
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                worker.queue.push_back(std::move(sub));
+                ++donated;
+            }
+            for (uint32_t j = dd; j < d; ++j)
+            {
+                place(j, replay[j - dd], state);
+            }
+            if (donated > 0)
+            {
+                return;
+            }
+        }
+    }
+
+    const LargeInstance& instance_;
+    uint32_t numThreads_;
+    uint64_t nodeLimit_;
+    std::chrono::milliseconds budget_;
+    std::chrono::steady_clock::time_point deadline_;
+    std::pmr::vector<uint32_t> order_;
+    std::vector<uint32_t> sizes_;
+    uint64_t knownBound_ = 0;
+    uint64_t lowerBound_ = 0;
+    uint32_t slice_ = 0;
+    std::atomic<uint32_t> cut_{ 0 };
+    uint32_t round_ = 0;
+    bool tight_ = false;
+    uint64_t runLimit_ = 0;
+    std::vector<Worker> workers_;
+    std::atomic<uint64_t> pending_{ 0 };
+    std::atomic<uint32_t> idle_{ 0 };
+    std::atomic<uint64_t> nodes_{ 0 };
+    std::atomic<bool> stop_{ false };
+    std::atomic<bool> limitHit_{ false };
+    std::atomic<bool> restart_{ false };
+    std::atomic<uint32_t> bestBins_{ 0 };
+    std::mutex bestMutex_;
+    std::vector<uint32_t> bestAssign_;
+    bool improved_ = false;
+};
+
+// ---------------Arc flow-------------------
+//
+// Arc-flow model of the instance: one node per bin load reachable from 0 by adding items
+// of the distinct sizes in decreasing order, each size at most as often as it occurs,
+// and one arc per (load, size) step. Every path from 0 is a bin pattern, so the flow
+// model is solved by column generation: a dense revised simplex over the covering LP
+// with one row per distinct size, priced by a longest path over the DAG with the duals
+// as arc values. The lower bound is Farley's: demand times duals over the best pattern
+// value, which holds for any duals, so it does not rest on the simplex having converged
+// exactly; rounded up, it is very often the optimum. The rounding takes every pattern of
+// the LP solution as often as its rounded-down value says, then the patterns with the
+// largest fractional parts and FFD for the rest. Unless that meets the bound, the integer
+// stage branches on the arc flow over the items left after the whole copies: it fixes
+// patterns of the LP solution and solves the LP of what is left again, depth first, with
+// the bound cutting branches. If that does not meet the bound either, those items go to
+// branch and bound, whose target is the LP bound less the bins already fixed. The best
+// packing replaces the incumbent when it uses fewer bins; it is proven optimal only once
+// it meets the bound.
+class ArcFlow
+{
+public:
+    // Largest capacity for which load-indexed arrays are built.
+    static constexpr uint32_t kMaxCapacity = 1u << 22;
+    // Patterns tried at a node of the dive that has no whole copies.
+    static constexpr size_t kDiveBranches = 3;
+
+    ArcFlow(const LargeInstance& instance, uint32_t numThreads, std::chrono::milliseconds budget)
+        : instance_(instance), numThreads_(numThreads), budget_(budget) {}
+
+    uint64_t getLowerBound() const { return lowerBound_; }
+    size_t getNumNodes() const { return numNodes_; }
+    size_t getNumArcs() const { return arcs_.size(); }
+
+    // binOf holds the incumbent packing into numBins bins. Returns the best bin count and
+    // leaves the best packing in binOf; proven tells whether it is optimal.
+    uint32_t solve(std::pmr::vector<uint32_t>& binOf, uint32_t numBins, bool& proven)
+    {
+        auto deadline = std::chrono::steady_clock::now() + budget_;
+        lowerBound_ = instance_.lowerBound();
+        proven = numBins <= lowerBound_;
+        if (proven || instance_.capacity > kMaxCapacity)
+        {
+            return numBins;
+        }
+        buildTypes();
+        if (types_.empty())
+        {
+            return numBins;
+        }
+        buildGraph();
+        if (!solveRelaxation(deadline))
+        {
+            return numBins;
+        }
+        uint32_t rounded = roundSolution(binOf, numBins, deadline);
+        proven = std::min(rounded, numBins) <= lowerBound_;
+        return std::min(rounded, numBins);
+    }
+
+private:
+    struct Arc
+    {
+        uint32_t tail;
+        uint32_t head;
+        uint32_t type;
+    };
+
+    // Distinct sizes in decreasing order, how often each occurs and the items of each.
+    void buildTypes()
+    {
+        std::pmr::vector<uint32_t> order = decreasingOrder(instance_, std::pmr::get_default_resource());
+        types_.clear();
+        demand_.clear();
+        typeStart_.clear();
+        items_.clear();
+        for (uint32_t i : order)
+        {
+            uint32_t size = instance_.sizes[i];
+            // Items of size 0 fit anywhere and are left to the first bin.
+            if (size == 0)
+            {
+                continue;
+            }
+            if (types_.empty() || types_.back() != size)
+            {
+                types_.push_back(size);
+                demand_.push_back(0);
+                typeStart_.push_back(static_cast<uint32_t>(items_.size()));
+            }
+            ++demand_.back();
+            items_.push_back(i);
+        }
+        typeStart_.push_back(static_cast<uint32_t>(items_.size()));
+    }
+
+    // Adds the sizes one after the other. copies[a] is the fewest items of the current
+    // size on a path to load a, or kNone if a is not reachable yet; arcs of a size leave
+    // every load that can take one more item of it.
+    void buildGraph()
+    {
+        uint32_t capacity = instance_.capacity;
+        std::vector<uint32_t> copies(size_t(capacity) + 1, kNone);
+        std::vector<char> reached(size_t(capacity) + 1, 0);
+        reached[0] = 1;
+        arcs_.clear();
+        for (uint32_t t = 0; t < types_.size(); ++t)
+        {
+            uint32_t w = types_[t];
+            for (uint32_t a = 0; a <= capacity; ++a)
+            {
+                copies[a] = reached[a] ? 0 : (a >= w && copies[a - w] < demand_[t] ? copies[a - w] + 1 : kNone);
+            }
+            for (uint32_t a = 0; a <= capacity; ++a)
+            {
+                if (copies[a] != kNone)
+                {
+                    reached[a] = 1;
+                    if (copies[a] < demand_[t] && a <= capacity - w)
+                    {
+                        arcs_.push_back({ a, a + w, t });
+                    }
+                }
+            }
+        }
+        std::sort(arcs_.begin(), arcs_.end(), [](const Arc& x, const Arc& y) { return x.tail < y.tail; });
+        // Compress the loads to node numbers.
+        nodeOf_.assign(size_t(capacity) + 1, kNone);
+        numNodes_ = 0;
+        for (uint32_t a = 0; a <= capacity; ++a)
+        {
+            if (reached[a])
+            {
+                nodeOf_[a] = static_cast<uint32_t>(numNodes_++);
+            }
+        }
+        for (Arc& arc : arcs_)
+        {
+            arc.tail = nodeOf_[arc.tail];
+            arc.head = nodeOf_[arc.head];
+        }
+    }
+
+    // Longest path from node 0 with the duals as arc values. Returns its value and the
+    // number of items of every size on it.
+    double price(const std::vector<double>& duals, std::vector<uint32_t>& pattern)
+    {
+        value_.assign(numNodes_, -1.0);
+        via_.assign(numNodes_, kNone);
+        value_[0] = 0;
+        for (uint32_t k = 0; k < arcs_.size(); ++k)
+        {
+            const Arc& arc = arcs_[k];
+            if (value_[arc.tail] >= 0 && value_[arc.tail] + duals[arc.type] > value_[arc.head])
+            {
+                value_[arc.head] = value_[arc.tail] + duals[arc.type];
+                via_[arc.head] = k;
+            }
+        }
+        uint32_t best = static_cast<uint32_t>(std::max_element(value_.begin(), value_.end()) - value_.begin());
+        pattern.assign(types_.size(), 0);
+        for (uint32_t node = best; via_[node] != kNone; node = arcs_[via_[node]].tail)
+        {
+            ++pattern[arcs_[via_[node]].type];
+        }
+        return value_[best];
+    }
+
+    // Revised simplex on min sum x_p subject to sum_p pattern_p x_p >= demand, starting
+    // from the basis of single-size patterns. Basis entries are pattern numbers, or
+    // kSurplus + t for the surplus variable of row t.
+    bool solveRelaxation(std::chrono::steady_clock::time_point deadline)
+    {
+        static constexpr double kEpsilon = 1e-9;
+        size_t m = types_.size();
+        patterns_.clear();
+        basis_.assign(m, 0);
+        inverse_.assign(m * m, 0.0);
+        primal_.assign(m, 0.0);
+        for (uint32_t t = 0; t < m; ++t)
+        {
+            std::vector<uint32_t> pattern(m, 0);
+            pattern[t] = std::min(demand_[t], instance_.capacity / types_[t]);
+            inverse_[t * m + t] = 1.0 / pattern[t];
+            primal_[t] = double(demand_[t]) / pattern[t];
+            basis_[t] = static_cast<uint32_t>(patterns_.size());
+            patterns_.push_back(std::move(pattern));
+        }
+
+        std::vector<double> duals(m);
+        std::vector<double> column(m);
+        std::vector<double> direction(m);
+        std::vector<uint32_t> pattern;
+        for (uint64_t iteration = 0; ; ++iteration)
+        {
+            for (size_t j = 0; j < m; ++j)
+            {
+                duals[j] = 0;
+                for (size_t i = 0; i < m; ++i)
+                {
+                    if (basis_[i] < kSurplus)
+                    {
+                        duals[j] += inverse_[i * m + j];
+                    }
+                }
+            }
+            if (iteration % 64 == 0 && std::chrono::steady_clock::now() >= deadline)
+            {
+                raiseBound(duals);
+                return false;
+            }
+            // A surplus variable with a negative dual enters first, then the best pattern.
+            uint32_t entering = kNone;
+            size_t row = std::min_element(duals.begin(), duals.end()) - duals.begin();
+            if (duals[row] < -kEpsilon)
+            {
+                entering = kSurplus + static_cast<uint32_t>(row);
+                std::fill(column.begin(), column.end(), 0.0);
+                column[row] = -1.0;
+            }
+            else if (price(duals, pattern) > 1.0 + kEpsilon)
+            {
+                entering = static_cast<uint32_t>(patterns_.size());
+                std::copy(pattern.begin(), pattern.end(), column.begin());
+            }
+            else
+            {
+                break;
+            }
+
+            size_t leaving = m;
+            double ratio = 0;
+            for (size_t i = 0; i < m; ++i)
+            {
+                direction[i] = 0;
+                for (size_t j = 0; j < m; ++j)
+                {
+                    direction[i] += inverse_[i * m + j] * column[j];
+                }
+                if (direction[i] > kEpsilon && (leaving == m || primal_[i] / direction[i] < ratio))
+                {
+                    leaving = i;
+                    ratio = primal_[i] / direction[i];
+                }
+            }
+            if (leaving == m)
+            {
+                return false;
+            }
+            if (entering < kSurplus)
+            {
+                patterns_.push_back(pattern);
+            }
+            double pivot = direction[leaving];
+            for (size_t j = 0; j < m; ++j)
+            {
+                inverse_[leaving * m + j] /= pivot;
+            }
+            for (size_t i = 0; i < m; ++i)
+            {
+                if (i != leaving && direction[i] != 0)
+                {
+                    for (size_t j = 0; j < m; ++j)
+                    {
+                        inverse_[i * m + j] -= direction[i] * inverse_[leaving * m + j];
+                    }
+                    primal_[i] -= direction[i] * ratio;
+                }
+            }
+            primal_[leaving] = ratio;
+            basis_[leaving] = entering;
+        }
+
+        raiseBound(duals);
+        return true;
+    }
+
+    // Farley's bound: with the negative duals set to 0 and z the best pattern value under
+    // them, duals / z is feasible for the dual LP, so demand times duals over z bounds the
+    // LP and every packing from below. The slack only absorbs rounding in the sums.
+    void raiseBound(std::vector<double> duals)
+    {
+        double total = 0;
+        for (size_t t = 0; t < duals.size(); ++t)
+        {
+            duals[t] = std::max(duals[t], 0.0);
+            total += demand_[t] * duals[t];
+        }
+        std::vector<uint32_t> pattern;
+        double best = price(duals, pattern);
+        if (best > 0)
+        {
+            double bound = std::ceil(total / best - 1e-6);
+            lowerBound_ = std::max<uint64_t>(lowerBound_, static_cast<uint64_t>(std::max(bound, 0.0)));
+        }
+    }
+
+    // Whole copies of the LP patterns, then one more copy of the patterns with the largest
+    // fractional parts while their items are still there, then FFD for the rest. Unless
+    // that meets the bound, a dive and then branch and bound repack what the whole copies
+    // left until the deadline. Returns the number of bins and writes the packing to binOf
+    // if it beats the incumbent.
+    uint32_t roundSolution(std::pmr::vector<uint32_t>& binOf, uint32_t numBins, std::chrono::steady_clock::time_point deadline)
+    {
+        uint32_t n = instance_.getNumItems();
+        std::vector<uint32_t> result(n, 0);
+        std::vector<uint32_t> taken(typeStart_.begin(), typeStart_.end() - 1);
+        uint32_t bins = 0;
+        auto takePattern = [&](const std::vector<uint32_t>& pattern) {
+            bool used = false;
+            for (uint32_t t = 0; t < pattern.size(); ++t)
+            {
+                for (uint32_t k = 0; k < pattern[t] && taken[t] < typeStart_[t + 1]; ++k)
+                {
+                    result[items_[taken[t]++]] = bins;
+                    used = true;
+                }
+            }
+            bins += used ? 1 : 0;
+        };
+        std::vector<size_t> fractional;
+        for (size_t i = 0; i < basis_.size(); ++i)
+        {
+            if (basis_[i] >= kSurplus)
+            {
+                continue;
+            }
+            for (uint64_t copy = 0; copy < static_cast<uint64_t>(primal_[i] + 1e-9); ++copy)
+            {
+                takePattern(patterns_[basis_[i]]);
+            }
+            fractional.push_back(i);
+        }
+        uint32_t fixed = bins;
+        std::vector<uint32_t> residualStart(taken);
+        auto fraction = [&](size_t i) { return primal_[i] - std::floor(primal_[i] + 1e-9); };
+        std::sort(fractional.begin(), fractional.end(), [&](size_t a, size_t b) { return fraction(a) > fraction(b); });
+        for (size_t i : fractional)
+        {
+            const std::vector<uint32_t>& pattern = patterns_[basis_[i]];
+            bool available = fraction(i) > 1e-9;
+            for (uint32_t t = 0; t < pattern.size() && available; ++t)
+            {
+                available = typeStart_[t + 1] - taken[t] >= pattern[t];
+            }
+            if (available)
+            {
+                takePattern(pattern);
+            }
+        }
+
+        LargeInstance rest;
+        rest.capacity = instance_.capacity;
+        std::vector<uint32_t> restItems;
+        for (uint32_t t = 0; t < types_.size(); ++t)
+        {
+            for (uint32_t k = taken[t]; k < typeStart_[t + 1]; ++k)
+            {
+                restItems.push_back(items_[k]);
+                rest.sizes.push_back(instance_.sizes[items_[k]]);
+            }
+        }
+        std::pmr::vector<uint32_t> restBinOf;
+        FirstFitTree index;
+        bins += packLarge(rest, decreasingOrder(rest, std::pmr::get_default_resource()), index, restBinOf);
+        for (uint32_t k = 0; k < restItems.size(); ++k)
+        {
+            result[restItems[k]] = bins - index.getNumBins() + restBinOf[k];
+        }
+
+        if (std::min(bins, numBins) > lowerBound_ && bins > fixed)
+        {
+            // The bins of the residual items are numbered from fixed on.
+            LargeInstance residual;
+            residual.capacity = instance_.capacity;
+            std::vector<uint32_t> residualItems;
+            for (uint32_t t = 0; t < types_.size(); ++t)
+            {
+                for (uint32_t k = residualStart[t]; k < typeStart_[t + 1]; ++k)
+                {
+                    residualItems.push_back(items_[k]);
+                    residual.sizes.push_back(instance_.sizes[items_[k]]);
+                }
+            }
+            // The dive writes to result only along a packing it returns.
+            uint32_t diveBins = dive(residual, residualItems, fixed, std::min(bins, numBins), result, deadline);
+            if (diveBins != kNone)
+            {
+                bins = diveBins;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (std::min(bins, numBins) > lowerBound_ && now < deadline)
+            {
+                std::pmr::vector<uint32_t> residualBinOf;
+                for (uint32_t item : residualItems)
+                {
+                    residualBinOf.push_back(result[item] - fixed);
+                }
+                BranchAndBound search(residual, numThreads_, 0, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now));
+                search.setLowerBound(lowerBound_ - fixed);
+                bool proven = false;
+                uint32_t residualBins = search.solve(residualBinOf, bins - fixed, proven);
+                if (fixed + residualBins < bins)
+                {
+                    for (uint32_t k = 0; k < residualItems.size(); ++k)
+                    {
+                        result[residualItems[k]] = fixed + residualBinOf[k];
+                    }
+                    bins = fixed + residualBins;
+                }
+            }
+        }
+
+        if (bins < numBins)
+        {
+            std::copy(result.begin(), result.end(), binOf.begin());
+        }
+        return bins;
+    }
+
+    // Branches on the arc flow, depth first: solves the LP of the items left and fixes the
+    // whole copies of its patterns, or else tries one copy of each of the kDiveBranches
+    // largest patterns in turn. A branch is cut once the bins so far plus the bound of the
+    // rest reach best, and the search of a node stops once a packing meets its bound. The
+    // bins are numbered from bins on; returns their count, with the packing of restItems in
+    // result, or kNone.
+    uint32_t dive(const LargeInstance& rest, const std::vector<uint32_t>& restItems, uint32_t bins, uint32_t best,
+        std::vector<uint32_t>& result, std::chrono::steady_clock::time_point deadline) const
+    {
+        if (rest.sizes.empty())
+        {
+            return bins;
+        }
+        // Every choice gives the bin of each item of rest it fixes, or kNone.
+        std::vector<std::vector<uint32_t>> choices;
+        std::vector<uint32_t> choiceBins;
+        uint64_t bound = 0;
+        {
+            ArcFlow step(rest, numThreads_, budget_);
+            step.lowerBound_ = rest.lowerBound();
+            step.buildTypes();
+            step.buildGraph();
+            if (!step.solveRelaxation(deadline) || bins + step.lowerBound_ >= best)
+            {
+                return kNone;
+            }
+            bound = bins + step.lowerBound_;
+            std::vector<size_t> basic;
+            std::vector<uint64_t> copies(step.basis_.size(), 0);
+            bool whole = false;
+            for (size_t i = 0; i < step.basis_.size(); ++i)
+            {
+                if (step.basis_[i] < kSurplus && step.primal_[i] > 1e-9)
+                {
+                    basic.push_back(i);
+                    copies[i] = static_cast<uint64_t>(step.primal_[i] + 1e-9);
+                    whole |= copies[i] > 0;
+                }
+            }
+            std::sort(basic.begin(), basic.end(), [&](size_t x, size_t y) { return step.primal_[x] > step.primal_[y]; });
+            if (!whole)
+            {
+                basic.resize(std::min<size_t>(basic.size(), kDiveBranches));
+                for (size_t i : basic)
+                {
+                    copies[i] = 1;
+                }
+            }
+            for (size_t i : basic)
+            {
+                if (whole && i != basic.front())
+                {
+                    continue;
+                }
+                std::vector<uint32_t> choice(rest.sizes.size(), kNone);
+                std::vector<uint32_t> taken(step.typeStart_.begin(), step.typeStart_.end() - 1);
+                uint32_t used = 0;
+                for (size_t j : basic)
+                {
+                    if (!whole && j != i)
+                    {
+                        continue;
+                    }
+                    const std::vector<uint32_t>& pattern = step.patterns_[step.basis_[j]];
+                    for (uint64_t copy = 0; copy < copies[j]; ++copy)
+                    {
+                        bool any = false;
+                        for (uint32_t t = 0; t < pattern.size(); ++t)
+                        {
+                            for (uint32_t k = 0; k < pattern[t] && taken[t] < step.typeStart_[t + 1]; ++k)
+                            {
+                                choice[step.items_[taken[t]++]] = used;
+                                any = true;
+                            }
+                        }
+                        used += any ? 1 : 0;
+                    }
+                }
+                choices.push_back(std::move(choice));
+                choiceBins.push_back(used);
+            }
+        }
+
+        uint32_t found = kNone;
+        for (size_t c = 0; c < choices.size() && found != bound && std::chrono::steady_clock::now() < deadline; ++c)
+        {
+            LargeInstance next;
+            next.capacity = rest.capacity;
+            std::vector<uint32_t> nextItems;
+            for (uint32_t k = 0; k < rest.sizes.size(); ++k)
+            {
+                if (choices[c][k] == kNone)
+                {
+                    nextItems.push_back(restItems[k]);
+                    next.sizes.push_back(rest.sizes[k]);
+                }
+            }
+            uint32_t packed = dive(next, nextItems, bins + choiceBins[c], best, result, deadline);
+            if (packed != kNone)
+            {
+                for (uint32_t k = 0; k < rest.sizes.size(); ++k)
+                {
+                    if (choices[c][k] != kNone)
+                    {
+                        result[restItems[k]] = bins + choices[c][k];
+                    }
+                }
+                best = found = packed;
+            }
+        }
+        return found;
+    }
+
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr uint32_t kSurplus = 1u << 31;
+
+    const LargeInstance& instance_;
+    uint32_t numThreads_;
+    std::chrono::milliseconds budget_;
+    uint64_t lowerBound_ = 0;
+    std::vector<uint32_t> types_;
+    std::vector<uint32_t> demand_;
+    std::vector<uint32_t> typeStart_;
+    std::vector<uint32_t> items_;
+    std::vector<uint32_t> nodeOf_;
+    size_t numNodes_ = 0;
+    std::vector<Arc> arcs_;
+    std::vector<double> value_;
+    std::vector<uint32_t> via_;
+    std::vector<std::vector<uint32_t>> patterns_;
+    std::vector<uint32_t> basis_;
+    std::vector<double> inverse_;
+    std::vector<double> primal_;
+};
+
+static bool endsWith(const std::string& text, const std::string& suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <file.vbpb|file.vbp|file.txt> [ffd|bfd] [--reduce] [--initial in.bin] [--improve ms] [--lns ms [--ruin k]]"
+                  << " [--gga ms [--population p]]"
+                  << " [--arcflow ms] [--exact ms [--threads t] [--nodes limit]]"
+                  << " [--assignment out.bin] [--huge-pages]" << std::endl;
+        return 1;
+    }
+
+    std::string path = argv[1];
+    std::string algorithm = "ffd";
+    std::string assignmentPath;
+    std::string initialPath;
+    bool reduce = false;
+    long improveMs = -1;
+    long lnsMs = -1;
+    uint32_t ruinBins = 3;
+    long ggaMs = -1;
+    uint32_t populationSize = 32;
+    long arcFlowMs = -1;
+    long exactMs = -1;
+    uint32_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t nodeLimit = 0;
+    bool hugePages = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--assignment" && i + 1 < argc)
+        {
+            assignmentPath = argv[++i];
+        }
+        else if (arg == "--reduce")
+        {
+            reduce = true;
+        }
+        else if (arg == "--initial" && i + 1 < argc)
+        {
+            initialPath = argv[++i];
+        }
+        else if (arg == "--improve" && i + 1 < argc)
+        {
+            improveMs = std::stol(argv[++i]);
+        }
+        else if (arg == "--lns" && i + 1 < argc)
+        {
+            lnsMs = std::stol(argv[++i]);
+        }
+        else if (arg == "--ruin" && i + 1 < argc)
+        {
+            ruinBins = std::max(1ul, std::stoul(argv[++i]));
+        }
+        else if (arg == "--gga" && i + 1 < argc)
+        {
+            ggaMs = std::stol(argv[++i]);
+        }
+        else if (arg == "--population" && i + 1 < argc)
+        {
+            populationSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--arcflow" && i + 1 < argc)
+        {
+            arcFlowMs = std::stol(argv[++i]);
+        }
+        else if (arg == "--exact" && i + 1 < argc)
+        {
+            exactMs = std::stol(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            numThreads = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--nodes" && i + 1 < argc)
+        {
+            nodeLimit = std::stoull(argv[++i]);
+        }
+        else if (arg == "--huge-pages")
+        {
+            hugePages = true;
+        }
+        else
+        {
+            algorithm = arg;
+        }
+    }
+
+    HugePageResource hugePageResource;
+    std::pmr::memory_resource* upstream = hugePages ? &hugePageResource : std::pmr::get_default_resource();
+    std::pmr::monotonic_buffer_resource arena(HugePageResource::kHugePage, upstream);
+
+    std::ifstream file(path, std::ios::binary);
+    LargeInstance instance(&arena);
+    bool ok = false;
+    if (file)
+    {
+        ok = endsWith(path, ".vbpb") ? readBinary(file, instance) : readText(file, instance, endsWith(path, ".vbp"));
+    }
+    if (!ok)
+    {
+        std::cerr << "Cannot read instance " << path << std::endl;
+        return 1;
+    }
+    for (uint32_t size : instance.sizes)
+    {
+        if (size > instance.capacity)
+        {
+            std::cerr << "Item of size " << size << " exceeds the capacity " << instance.capacity << std::endl;
+            return 1;
+        }
+    }
+
+    if (reduce && !initialPath.empty())
+    {
+        std::cerr << "--reduce cannot be combined with --initial" << std::endl;
+        return 1;
+    }
+
+    // With --reduce every later stage packs only the residual instance; the fixed bins
+    // are put back in front of its bins at the end.
+    LargeInstance residual(&arena);
+    std::pmr::vector<uint32_t> residualItems(&arena);
+    std::pmr::vector<uint32_t> fixedBinOf(&arena);
+    uint32_t fixedBins = 0;
+    if (reduce)
+    {
+        auto reduce_start = std::chrono::high_resolution_clock::now();
+        Reduction reduction(instance, &arena);
+        fixedBins = reduction.reduce(fixedBinOf, residual, residualItems);
+        auto reduce_end = std::chrono::high_resolution_clock::now();
+        auto reduce_duration = std::chrono::duration_cast<std::chrono::microseconds>(reduce_end - reduce_start);
+
+        std::cout << "Items after reduction: " << residual.getNumItems() << " (" << fixedBins << " bins fixed)" << std::endl;
+        std::cout << "Execution time for reduction: " << reduce_duration.count() << " microseconds" << std::endl;
+    }
+    const LargeInstance& work = reduce ? residual : instance;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::pmr::vector<uint32_t> binOf(&arena);
+    uint32_t numBins = 0;
+    if (!initialPath.empty())
+    {
+        // A packing from another engine, in the format written by --assignment.
+        algorithm = "initial packing";
+        std::ifstream in(initialPath, std::ios::binary);
+        binOf.resize(instance.getNumItems());
+        if (!in.read(reinterpret_cast<char*>(binOf.data()), binOf.size() * sizeof(uint32_t)))
+        {
+            std::cerr << "Cannot read " << initialPath << std::endl;
+            return 1;
+        }
+        // A packing never needs more bins than items, which also keeps load below small.
+        for (uint32_t bin : binOf)
+        {
+            if (bin >= instance.getNumItems())
+            {
+                std::cerr << "Bin " << bin << " of " << initialPath << " is out of range" << std::endl;
+                return 1;
+            }
+            numBins = std::max(numBins, bin + 1);
+        }
+        std::pmr::vector<uint64_t> load(numBins, 0, &arena);
+        for (uint32_t i = 0; i < instance.getNumItems(); ++i)
+        {
+            if ((load[binOf[i]] += instance.sizes[i]) > instance.capacity)
+            {
+                std::cerr << "Bin " << binOf[i] << " of " << initialPath << " exceeds the capacity" << std::endl;
+                return 1;
+            }
+        }
+    }
+    else
+    {
+        std::pmr::vector<uint32_t> order = decreasingOrder(work, &arena);
+        if (algorithm == "bfd")
+        {
+            numBins = packBestFit(work, order, binOf, &arena);
+        }
+        else
+        {
+            FirstFitTree index(&arena);
+            numBins = packLarge(work, order, index, binOf);
+        }
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+    std::cout << "Items: " << instance.getNumItems() << ", capacity: " << instance.capacity
+              << ", total size: " << instance.totalSize() << std::endl;
+    std::cout << "Lower bound: " << instance.lowerBound() << std::endl;
+    std::cout << "Number of bins used: " << fixedBins + numBins << std::endl;
+    std::cout << "Execution time for " << algorithm << ": " << duration.count() << " microseconds" << std::endl;
+
+    if (improveMs >= 0)
+    {
+        auto search_start = std::chrono::high_resolution_clock::now();
+        LocalSearch search(work, &arena);
+        numBins = search.improve(binOf, numBins, std::chrono::milliseconds(improveMs));
+        auto search_end = std::chrono::high_resolution_clock::now();
+        auto search_duration = std::chrono::duration_cast<std::chrono::microseconds>(search_end - search_start);
+
+        std::cout << "Number of bins after local search: " << fixedBins + numBins << std::endl;
+        std::cout << "Execution time for local search: " << search_duration.count() << " microseconds" << std::endl;
+    }
+
+    if (lnsMs >= 0)
+    {
+        auto search_start = std::chrono::high_resolution_clock::now();
+        LocalSearch search(work, &arena);
+        uint64_t iterations = 0;
+        numBins = search.searchLarge(binOf, numBins, std::chrono::milliseconds(lnsMs), ruinBins, iterations);
+        auto search_end = std::chrono::high_resolution_clock::now();
+        auto search_duration = std::chrono::duration_cast<std::chrono::microseconds>(search_end - search_start);
+
+        std::cout << "Number of bins after large neighbourhood search: " << fixedBins + numBins << " (" << iterations << " iterations)" << std::endl;
+        std::cout << "Execution time for large neighbourhood search: " << search_duration.count() << " microseconds" << std::endl;
+    }
+
+    if (ggaMs >= 0)
+    {
+        auto search_start = std::chrono::high_resolution_clock::now();
+        GroupingGA search(work, populationSize, numThreads, std::chrono::milliseconds(ggaMs), &arena);
+        numBins = search.solve(binOf, numBins);
+        auto search_end = std::chrono::high_resolution_clock::now();
+        auto search_duration = std::chrono::duration_cast<std::chrono::microseconds>(search_end - search_start);
+
+        std::cout << "Number of bins after grouping GA: " << fixedBins + numBins << " (" << search.getGenerations() << " generations)" << std::endl;
+        std::cout << "Execution time for grouping GA: " << search_duration.count() << " microseconds" << std::endl;
+    }
+
+    if (arcFlowMs >= 0)
+    {
+        auto search_start = std::chrono::high_resolution_clock::now();
+        ArcFlow model(work, numThreads, std::chrono::milliseconds(arcFlowMs));
+        bool proven = false;
+        numBins = model.solve(binOf, numBins, proven);
+        auto search_end = std::chrono::high_resolution_clock::now();
+        auto search_duration = std::chrono::duration_cast<std::chrono::microseconds>(search_end - search_start);
+
+        std::cout << "Arc-flow graph: " << model.getNumNodes() << " nodes, " << model.getNumArcs() << " arcs" << std::endl;
+        std::cout << "Arc-flow lower bound: " << fixedBins + model.getLowerBound() << std::endl;
+        std::cout << "Number of bins after arc flow: " << fixedBins + numBins << (proven ? " (optimal)" : " (not proven)") << std::endl;
+        std::cout << "Execution time for arc flow: " << search_duration.count() << " microseconds" << std::endl;
+    }
+
+    if (exactMs >= 0)
+    {
+        auto search_start = std::chrono::high_resolution_clock::now();
+        BranchAndBound search(work, numThreads, nodeLimit, std::chrono::milliseconds(exactMs));
+        bool proven = false;
+        numBins = search.solve(binOf, numBins, proven);
+        auto search_end = std::chrono::high_resolution_clock::now();
+        auto search_duration = std::chrono::duration_cast<std::chrono::microseconds>(search_end - search_start);
+
+        std::cout << "Branch-and-bound lower bound: " << fixedBins + search.getLowerBound() << std::endl;
+        std::cout << "Number of bins after branch and bound: " << fixedBins + numBins << (proven ? " (optimal, " : " (not proven, ")
+                  << search.getNodes() << " nodes)" << std::endl;
+        std::cout << "Execution time for branch and bound: " << search_duration.count() << " microseconds" << std::endl;
+    }
+
+    if (reduce)
+    {
+        for (uint32_t k = 0; k < residualItems.size(); ++k)
+        {
+            fixedBinOf[residualItems[k]] = fixedBins + binOf[k];
+        }
+        binOf.swap(fixedBinOf);
+    }
+
+    if (!assignmentPath.empty())
+    {
+        std::ofstream out(assignmentPath, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(binOf.data()), binOf.size() * sizeof(uint32_t));
+        if (!out)
+        {
+            std::cerr << "Cannot write " << assignmentPath << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// Solution output. Text is formatted with std::to_chars into a large buffer that is
+// reused between flushes; once it is full, or on flush(), it is handed to a background
+// thread that writes it to stdout while the caller goes on with the next buffer.
+// Quiet mode skips the bin listings so benchmarks only pay for the summary lines.
+class SolutionWriter
+{
+public:
+    static constexpr size_t kBufferSize = 1 << 20;
+
+    SolutionWriter()
+    {
+        buffer_.reserve(kBufferSize);
+        pending_.reserve(kBufferSize);
+    }
+
+    ~SolutionWriter()
+    {
+        flush();
+    }
+
+    void setQuiet(bool quiet) { quiet_ = quiet; }
+    bool isQuiet() const { return quiet_; }
+
+    SolutionWriter& operator<<(const char* text)
+    {
+        buffer_.append(text);
+        return flushIfFull();
+    }
+
+    SolutionWriter& operator<<(const std::string& text)
+    {
+        buffer_.append(text);
+        return flushIfFull();
+    }
+
+    SolutionWriter& operator<<(char c)
+    {
+        buffer_.push_back(c);
+        return flushIfFull();
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    SolutionWriter& operator<<(T value)
+    {
+        char text[24];
+        buffer_.append(text, std::to_chars(text, text + sizeof(text), value).ptr);
+        return flushIfFull();
+    }
+
+    // Same digits as the default std::ostream formatting.
+    SolutionWriter& operator<<(double value)
+    {
+        char text[32];
+        buffer_.append(text, std::to_chars(text, text + sizeof(text), value, std::chars_format::general, 6).ptr);
+        return flushIfFull();
+    }
+
+    // Writes out everything buffered so far and waits until it is written.
+    void flush()
+    {
+        flushAsync();
+        wait();
+    }
+
+    // Hands the buffer to the background thread and returns at once.
+    void flushAsync()
+    {
+        if (buffer_.empty())
+        {
+            return;
+        }
+        wait();
+        buffer_.swap(pending_);
+        buffer_.clear();
+        worker_ = std::thread([this]() {
+            std::fwrite(pending_.data(), 1, pending_.size(), stdout);
+            std::fflush(stdout);
+            });
+    }
+
+private:
+    SolutionWriter& flushIfFull()
+    {
+        if (buffer_.size() >= kBufferSize)
+        {
+            flushAsync();
+        }
+        return *this;
+    }
+
+    void wait()
+    {
+        if (worker_.joinable())
+        {
+            worker_.join();
+        }
+    }
+
+    std::string buffer_;
+    std::string pending_;
+    std::thread worker_;
+    bool quiet_ = false;
+};
@@ -0,0 +1,1106 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+#include <random>
+#include <functional>
+
+// ---------------Vector bin packing (FFD / BFD / WFD / MB)-------------------
+//
+// d-dimensional version of the item-centric and multibin engines for the
+// .vbp instances in data/Multidim and data/Falkenauer*.
+// Items and bins are stored as structure of arrays: every dimension has its own
+// contiguous column, so the fit test for a block of bins is one compare per
+// dimension over consecutive ints, AND-ed together into a bit mask.
+// The bin store and engines are templated on the dimension count: for Dim > 0
+// every per-dimension loop is unrolled at compile time, Dim == 0 is the
+// dynamic fallback that reads the count from the instance.
+
+// Bin selection: first fit, or the fitting bin with the lowest score where
+//   Best   sum of relative residuals after placement (smallest),
+//   Worst  sum of relative residuals after placement (largest),
+//   DotProduct  dot product of item and residual capacity (largest),
+//   L2Norm      L2 norm of the residual after placement (smallest).
+enum class FitRule { First, Best, Worst, DotProduct, L2Norm };
+
+// Item ordering key, items are packed by decreasing key. Sizes are taken
+// relative to the capacity of their dimension.
+enum class ItemOrder { Sum, Product, Max, L2 };
+
+// Calls f(0) .. f(Dim - 1) as an unrolled sequence, or loops up to dim when Dim == 0.
+template <int Dim, typename F, int... D>
+inline void forEachDimUnrolled(F&& f, std::integer_sequence<int, D...>)
+{
+    (f(D), ...);
+}
+
+template <int Dim, typename F>
+inline void forEachDim(int dim, F&& f)
+{
+    if constexpr (Dim > 0)
+    {
+        forEachDimUnrolled<Dim>(f, std::make_integer_sequence<int, Dim>());
+    }
+    else
+    {
+        for (int d = 0; d < dim; ++d)
+        {
+            f(d);
+        }
+    }
+}
+
+// Item sizes, column d holds sizes[d * n .. d * n + n).
+class VectorItems
+{
+public:
+    int dim = 0;
+    std::vector<int> capacities;
+    std::vector<int> sizes;
+    std::vector<int> ids;
+
+    int getNumItems() const { return static_cast<int>(ids.size()); }
+    int getSize(int item, int d) const { return sizes[static_cast<size_t>(d) * ids.size() + item]; }
+    int getCapacity(int d) const { return capacities[d]; }
+
+    // Lower bound max_d ceil(sum of sizes in d / capacity in d).
+    int lowerBound() const
+    {
+        int bound = 0;
+        int n = getNumItems();
+        for (int d = 0; d < dim; ++d)
+        {
+            long long volume = 0;
+            for (int i = 0; i < n; ++i)
+            {
+                volume += getSize(i, d);
+            }
+            bound = std::max(bound, static_cast<int>((volume + capacities[d] - 1) / capacities[d]));
+        }
+        return bound;
+    }
+
+    // Reorders the items by decreasing key. The keys are accumulated one
+    // dimension column at a time so the loops vectorise over the items.
+    void sortDecreasing(ItemOrder order)
+    {
+        int n = getNumItems();
+        std::vector<double> key(n, order == ItemOrder::Product ? 1.0 : 0.0);
+        for (int d = 0; d < dim; ++d)
+        {
+            const int* column = sizes.data() + static_cast<size_t>(d) * n;
+            double scale = 1.0 / capacities[d];
+            switch (order)
+            {
+            case ItemOrder::Sum:
+                for (int i = 0; i < n; ++i)
+                {
+                    key[i] += column[i] * scale;
+                }
+                break;
+            case ItemOrder::Product:
+                for (int i = 0; i < n; ++i)
+                {
+                    key[i] *= column[i] * scale;
+                }
+                break;
+            case ItemOrder::Max:
+                for (int i = 0; i < n; ++i)
+                {
+                    key[i] = std::max(key[i], column[i] * scale);
+                }
+                break;
+            case ItemOrder::L2:
+                for (int i = 0; i < n; ++i)
+                {
+                    key[i] += (column[i] * scale) * (column[i] * scale);
+                }
+                break;
+            }
+        }
+        sortByKey(key);
+    }
+
+    // Row i holds, for every dimension, the smallest size over items i .. n-1, so
+    // after placing item i the rows from i + 1 bound every item still to come.
+    std::vector<int> suffixMinima() const
+    {
+        int n = getNumItems();
+        std::vector<int> minima(static_cast<size_t>(n) * dim);
+        for (int d = 0; d < dim; ++d)
+        {
+            int smallest = capacities[d];
+            for (int i = n - 1; i >= 0; --i)
+            {
+                smallest = std::min(smallest, getSize(i, d));
+                minima[static_cast<size_t>(i) * dim + d] = smallest;
+            }
+        }
+        return minima;
+    }
+
+private:
+    void sortByKey(const std::vector<double>& key)
+    {
+        int n = getNumItems();
+        std::vector<int> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return key[a] > key[b]; });
+
+        std::vector<int> sorted(sizes.size());
+        std::vector<int> sortedIds(n);
+        for (int i = 0; i < n; ++i)
+        {
+            sortedIds[i] = ids[order[i]];
+            for (int d = 0; d < dim; ++d)
+            {
+                sorted[static_cast<size_t>(d) * n + i] = getSize(order[i], d);
+            }
+        }
+        sizes.swap(sorted);
+        ids.swap(sortedIds);
+    }
+};
+
+// Remaining capacities, column d holds remaining[d * stride .. d * stride + stride).
+// Slots past the last open bin hold -1 so they never fit and scans can run over
+// whole blocks. A bin that can no longer hold any of the remaining items is retired:
+// its slot is set to -1 as well and retired slots are dropped from the scan set once
+// they are half of it. Slot s holds bin getBinId(s), the open bins keep their order.
+template <int Dim>
+class VectorBins
+{
+public:
+    static constexpr int kBlock = 16;
+
+    VectorBins(const std::vector<int>& capacities)
+        : dim_(Dim > 0 ? Dim : static_cast<int>(capacities.size())), capacities_(capacities), count_(0), stride_(0),
+          numBins_(0), numRetired_(0)
+    {
+        for (int capacity : capacities_)
+        {
+            scales_.push_back(1.0f / capacity);
+        }
+    }
+
+    int getNumBins() const { return numBins_; }
+    int getBinId(int slot) const { return binIds_[slot]; }
+    int getRemaining(int slot, int d) const { return remaining_[static_cast<size_t>(d) * stride_ + slot]; }
+
+    int openBin()
+    {
+        if (count_ == stride_)
+        {
+            grow(std::max(kBlock, stride_ * 2));
+        }
+        forEachDim<Dim>(dim_, [&](int d) {
+            remaining_[static_cast<size_t>(d) * stride_ + count_] = capacities_[d];
+            });
+        binIds_.push_back(numBins_++);
+        return count_++;
+    }
+
+    void addItem(int bin, const int* size)
+    {
+        forEachDim<Dim>(dim_, [&](int d) {
+            remaining_[static_cast<size_t>(d) * stride_ + bin] -= size[d];
+            });
+    }
+
+    // Retires the bin in slot when it is below smallest in some dimension.
+    void retireIfUnusable(int slot, const int* smallest)
+    {
+        bool unusable = false;
+        forEachDim<Dim>(dim_, [&](int d) {
+            unusable |= remaining_[static_cast<size_t>(d) * stride_ + slot] < smallest[d];
+            });
+        if (!unusable)
+        {
+            return;
+        }
+        forEachDim<Dim>(dim_, [&](int d) {
+            remaining_[static_cast<size_t>(d) * stride_ + slot] = -1;
+            });
+        if (++numRetired_ >= kBlock && 2 * numRetired_ >= count_)
+        {
+            removeRetired();
+        }
+    }
+
+    // Bit k is set when bin first + k can hold the item.
+    uint32_t fitMask(int first, const int* size) const
+    {
+        uint32_t mask = ~0u;
+        forEachDim<Dim>(dim_, [&](int d) {
+            const int* column = remaining_.data() + static_cast<size_t>(d) * stride_ + first;
+            int s = size[d];
+            uint32_t dimMask = 0;
+            for (int k = 0; k < kBlock; ++k)
+            {
+                dimMask |= static_cast<uint32_t>(column[k] >= s) << k;
+            }
+            mask &= dimMask;
+            });
+        return mask;
+    }
+
+    // Returns the chosen bin or -1 when no open bin can hold the item.
+    int findBin(const int* size, FitRule rule) const
+    {
+        int best = -1;
+        float bestScore = 0.0f;
+        float scores[kBlock];
+        for (int first = 0; first < count_; first += kBlock)
+        {
+            uint32_t mask = fitMask(first, size);
+            if (mask == 0)
+            {
+                continue;
+            }
+            if (rule == FitRule::First)
+            {
+                return first + __builtin_ctz(mask);
+            }
+            blockScores(first, size, rule, scores);
+            while (mask != 0)
+            {
+                int k = __builtin_ctz(mask);
+                mask &= mask - 1;
+                if (best == -1 || scores[k] < bestScore)
+                {
+                    best = first + k;
+                    bestScore = scores[k];
+                }
+            }
+        }
+        return best;
+    }
+
+private:
+    // Scores all kBlock bins of the block at once, lower is better. Every rule is
+    // a sum over dimensions of an expression of one residual column, so each
+    // dimension is one vectorisable pass over contiguous residuals.
+    void blockScores(int first, const int* size, FitRule rule, float* scores) const
+    {
+        std::fill(scores, scores + kBlock, 0.0f);
+        forEachDim<Dim>(dim_, [&](int d) {
+            const int* column = remaining_.data() + static_cast<size_t>(d) * stride_ + first;
+            float scale = scales_[d];
+            float s = static_cast<float>(size[d]);
+            float item = s * scale;
+            switch (rule)
+            {
+            case FitRule::Best:
+                for (int k = 0; k < kBlock; ++k)
+                {
+                    scores[k] += (column[k] - s) * scale;
+                }
+                break;
+            case FitRule::Worst:
+                for (int k = 0; k < kBlock; ++k)
+                {
+                    scores[k] -= (column[k] - s) * scale;
+                }
+                break;
+            case FitRule::DotProduct:
+                for (int k = 0; k < kBlock; ++k)
+                {
+                    scores[k] -= item * (column[k] * scale);
+                }
+                break;
+            case FitRule::L2Norm:
+                for (int k = 0; k < kBlock; ++k)
+                {
+                    float residual = (column[k] - s) * scale;
+                    scores[k] += residual * residual;
+                }
+                break;
+            case FitRule::First:
+                break;
+            }
+            });
+    }
+
+    void removeRetired()
+    {
+        int kept = 0;
+        for (int slot = 0; slot < count_; ++slot)
+        {
+            if (remaining_[slot] != -1)
+            {
+                binIds_[kept] = binIds_[slot];
+                forEachDim<Dim>(dim_, [&](int d) {
+                    remaining_[static_cast<size_t>(d) * stride_ + kept] = remaining_[static_cast<size_t>(d) * stride_ + slot];
+                    });
+                ++kept;
+            }
+        }
+        forEachDim<Dim>(dim_, [&](int d) {
+            std::fill_n(remaining_.begin() + static_cast<size_t>(d) * stride_ + kept, count_ - kept, -1);
+            });
+        binIds_.resize(kept);
+        count_ = kept;
+        numRetired_ = 0;
+    }
+
+    void grow(int newStride)
+    {
+        std::vector<int> grown(static_cast<size_t>(dim_) * newStride, -1);
+        for (int d = 0; d < dim_; ++d)
+        {
+            std::copy_n(remaining_.begin() + static_cast<size_t>(d) * stride_, count_,
+                grown.begin() + static_cast<size_t>(d) * newStride);
+        }
+        remaining_.swap(grown);
+        stride_ = newStride;
+    }
+
+    int dim_;
+    std::vector<int> capacities_;
+    std::vector<float> scales_;
+    int count_;
+    int stride_;
+    int numBins_;
+    int numRetired_;
+    std::vector<int> remaining_;
+    std::vector<int> binIds_;
+};
+
+bool readVbp(std::istream& in, VectorItems& items)
+{
+    std::string line;
+    auto nextLine = [&]() {
+        while (std::getline(in, line))
+        {
+            // Some generated files write the capacities as a Python list.
+            for (char& c : line)
+            {
+                if (c == '[' || c == ']' || c == ',')
+                {
+                    c = ' ';
+                }
+            }
+            if (line.find_first_not_of(" \t\r") != std::string::npos)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    int numItems = 0;
+    if (!nextLine() || !(std::istringstream(line) >> items.dim) || items.dim <= 0)
+    {
+        return false;
+    }
+    if (!nextLine())
+    {
+        return false;
+    }
+    std::istringstream capacityLine(line);
+    items.capacities.assign(items.dim, 0);
+    for (int& capacity : items.capacities)
+    {
+        if (!(capacityLine >> capacity) || capacity <= 0)
+        {
+            return false;
+        }
+    }
+    if (!nextLine() || !(std::istringstream(line) >> numItems))
+    {
+        return false;
+    }
+
+    // Every item line holds dim sizes and an optional demand (number of copies).
+    std::vector<int> rows;
+    items.ids.clear();
+    for (int i = 0; i < numItems && nextLine(); ++i)
+    {
+        std::istringstream row(line);
+        std::vector<int> values(items.dim);
+        for (int& value : values)
+        {
+            if (!(row >> value))
+            {
+                return false;
+            }
+        }
+        int demand = 1;
+        row >> demand;
+        for (int copy = 0; copy < demand; ++copy)
+        {
+            rows.insert(rows.end(), values.begin(), values.end());
+            items.ids.push_back(i + 1);
+        }
+    }
+
+    int n = items.getNumItems();
+    items.sizes.assign(static_cast<size_t>(items.dim) * n, 0);
+    for (int i = 0; i < n; ++i)
+    {
+        for (int d = 0; d < items.dim; ++d)
+        {
+            items.sizes[static_cast<size_t>(d) * n + i] = rows[static_cast<size_t>(i) * items.dim + d];
+        }
+    }
+    return true;
+}
+
+template <int Dim>
+class VectorBinPacking
+{
+public:
+    VectorBinPacking(const std::vector<int>& capacities, FitRule rule) : bins_(capacities), rule_(rule) {}
+
+    // Places the items in their current order, opening bins as needed.
+    void packItems(const VectorItems& items)
+    {
+        int n = items.getNumItems();
+        std::vector<int> size(items.dim);
+        std::vector<int> smallest = items.suffixMinima();
+        assignment_.assign(n, -1);
+        for (int i = 0; i < n; ++i)
+        {
+            forEachDim<Dim>(items.dim, [&](int d) { size[d] = items.getSize(i, d); });
+            int slot = bins_.findBin(size.data(), rule_);
+            if (slot == -1)
+            {
+                slot = bins_.openBin();
+            }
+            bins_.addItem(slot, size.data());
+            assignment_[i] = bins_.getBinId(slot);
+            if (i + 1 < n)
+            {
+                bins_.retireIfUnusable(slot, smallest.data() + static_cast<size_t>(i + 1) * items.dim);
+            }
+        }
+    }
+
+    int getNumBins() const { return bins_.getNumBins(); }
+    const std::vector<int>& getAssignment() const { return assignment_; }
+
+private:
+    VectorBins<Dim> bins_;
+    FitRule rule_;
+    std::vector<int> assignment_;
+};
+
+// Multibin probe: tries to pack all items into a fixed number of bins, starting
+// at the lower bound and growing by batchIncrement until maxBins.
+template <int Dim>
+class VectorMultibin
+{
+public:
+    VectorMultibin(int maxBins, int batchIncrement, FitRule rule)
+        : maxBins_(maxBins), batchIncrement_(batchIncrement), rule_(rule), numBins_(0) {}
+
+    bool packItems(const VectorItems& items)
+    {
+        int n = std::max(1, items.lowerBound());
+        std::vector<int> smallest = items.suffixMinima();
+        while (n <= maxBins_)
+        {
+            if (packItemsIntoBins(items, smallest, n))
+            {
+                numBins_ = n;
+                return true;
+            }
+            n += batchIncrement_;
+        }
+        return false;
+    }
+
+    int getNumBins() const { return numBins_; }
+    const std::vector<int>& getAssignment() const { return assignment_; }
+
+private:
+    bool packItemsIntoBins(const VectorItems& items, const std::vector<int>& smallest, int numBins)
+    {
+        VectorBins<Dim> bins(items.capacities);
+        for (int b = 0; b < numBins; ++b)
+        {
+            bins.openBin();
+        }
+
+        int n = items.getNumItems();
+        std::vector<int> size(items.dim);
+        assignment_.assign(n, -1);
+        for (int i = 0; i < n; ++i)
+        {
+            forEachDim<Dim>(items.dim, [&](int d) { size[d] = items.getSize(i, d); });
+            int slot = bins.findBin(size.data(), rule_);
+            if (slot == -1)
+            {
+                return false;
+            }
+            bins.addItem(slot, size.data());
+            assignment_[i] = bins.getBinId(slot);
+            if (i + 1 < n)
+            {
+                bins.retireIfUnusable(slot, smallest.data() + static_cast<size_t>(i + 1) * items.dim);
+            }
+        }
+        return true;
+    }
+
+    int maxBins_;
+    int batchIncrement_;
+    FitRule rule_;
+    int numBins_;
+    std::vector<int> assignment_;
+};
+
+// Perfect-triplet instances (Falkenauer T, data/Multidim/t): n = 3m items that fill m
+// bins exactly, three to a bin, in every dimension. isTripletInstance() checks the
+// necessary volume condition. pack() groups equal items into classes kept in a hash of
+// their size vectors and lists every class triplet that fills a bin exactly. Each
+// triplet is found once, from its heaviest class: the second class is scanned only
+// between half the residual's weight and the residual's, and the third is looked up in
+// the hash by the complementary size vector. The search then repeatedly takes the class
+// with the fewest triplets still available per item left and uses one of them. A search
+// that stalls is restarted with the options shuffled and a larger step limit; after
+// maxSteps choices in all the caller falls back to the general engines.
+class TripletSolver
+{
+public:
+    static bool isTripletInstance(const VectorItems& items)
+    {
+        int n = items.getNumItems();
+        if (n == 0 || n % 3 != 0)
+        {
+            return false;
+        }
+        for (int d = 0; d < items.dim; ++d)
+        {
+            long long volume = 0;
+            for (int i = 0; i < n; ++i)
+            {
+                volume += items.getSize(i, d);
+            }
+            if (volume != static_cast<long long>(n / 3) * items.capacities[d])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns false when no perfect packing was found within maxSteps choices.
+    bool pack(const VectorItems& items, long long maxSteps)
+    {
+        buildClasses(items);
+        buildTriplets(items);
+
+        long long limit = items.getNumItems();
+        exhausted_ = false;
+        while (!search(limit))
+        {
+            maxSteps -= limit;
+            if (exhausted_ || maxSteps <= 0)
+            {
+                return false;
+            }
+            for (const Frame& frame : frames_)
+            {
+                apply(frame.triplet, 1);
+            }
+            for (std::vector<int>& options : classTriplets_)
+            {
+                std::shuffle(options.begin(), options.end(), random_);
+            }
+            limit = std::min(maxSteps, limit + limit / 2);
+        }
+
+        assignment_.assign(items.getNumItems(), -1);
+        std::vector<int> next(classItems_.size(), 0);
+        for (int bin = 0; bin < static_cast<int>(frames_.size()); ++bin)
+        {
+            for (int cls : triplets_[frames_[bin].triplet].classes)
+            {
+                assignment_[classItems_[cls][next[cls]++]] = bin;
+            }
+        }
+        return true;
+    }
+
+    int getNumBins() const { return static_cast<int>(frames_.size()); }
+    const std::vector<int>& getAssignment() const { return assignment_; }
+
+private:
+    // Three classes in increasing order, a class can occur more than once.
+    struct Triplet
+    {
+        int classes[3];
+    };
+
+    // A choice: the class to cover, the next of its triplets to try and the one in use.
+    struct Frame
+    {
+        int cls;
+        int pos;
+        int triplet;
+    };
+
+    // Depth-first search with at most limit choices. On failure frames_ holds the
+    // triplets still in use, none if the whole tree was searched.
+    bool search(long long limit)
+    {
+        int remaining = std::accumulate(count_.begin(), count_.end(), 0);
+        long long steps = 0;
+        frames_.clear();
+        bool descending = true;
+        while (true)
+        {
+            if (descending)
+            {
+                if (remaining == 0)
+                {
+                    return true;
+                }
+                if (++steps > limit)
+                {
+                    return false;
+                }
+                int cls = chooseClass();
+                if (cls != -1)
+                {
+                    frames_.push_back({ cls, 0, -1 });
+                }
+            }
+            if (frames_.empty())
+            {
+                exhausted_ = true;
+                return false;
+            }
+            // Undo the triplet of the top frame and take its next available one.
+            Frame& frame = frames_.back();
+            if (frame.triplet != -1)
+            {
+                apply(frame.triplet, 1);
+                remaining += 3;
+                frame.triplet = -1;
+            }
+            const std::vector<int>& options = classTriplets_[frame.cls];
+            while (frame.pos < static_cast<int>(options.size()) && !available(options[frame.pos]))
+            {
+                ++frame.pos;
+            }
+            if (frame.pos < static_cast<int>(options.size()))
+            {
+                frame.triplet = options[frame.pos++];
+                apply(frame.triplet, -1);
+                remaining -= 3;
+                descending = true;
+            }
+            else
+            {
+                frames_.pop_back();
+                descending = false;
+            }
+        }
+    }
+
+    static uint64_t key(const int* size, int dim)
+    {
+        uint64_t h = 1469598103934665603ull;
+        for (int d = 0; d < dim; ++d)
+        {
+            h = (h ^ static_cast<uint32_t>(size[d])) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Equal size vectors form one class; a bucket of the hash may hold several classes.
+    void buildClasses(const VectorItems& items)
+    {
+        int n = items.getNumItems();
+        dim_ = items.dim;
+        buckets_.clear();
+        classSizes_.clear();
+        classItems_.clear();
+        std::vector<int> size(dim_);
+        for (int i = 0; i < n; ++i)
+        {
+            for (int d = 0; d < dim_; ++d)
+            {
+                size[d] = items.getSize(i, d);
+            }
+            int cls = findClass(size.data());
+            if (cls == -1)
+            {
+                cls = static_cast<int>(classItems_.size());
+                buckets_[key(size.data(), dim_)].push_back(cls);
+                classSizes_.insert(classSizes_.end(), size.begin(), size.end());
+                classItems_.emplace_back();
+            }
+            classItems_[cls].push_back(i);
+        }
+
+        // Renumber the classes by decreasing weight, the sum of their relative sizes.
+        int numClasses = static_cast<int>(classItems_.size());
+        std::vector<double> weight(numClasses, 0.0);
+        for (int cls = 0; cls < numClasses; ++cls)
+        {
+            for (int d = 0; d < dim_; ++d)
+            {
+                weight[cls] += classSizes_[static_cast<size_t>(cls) * dim_ + d]
+                    / static_cast<double>(items.getCapacity(d));
+            }
+        }
+        std::vector<int> order(numClasses);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return weight[a] > weight[b]; });
+        std::vector<int> sizes(classSizes_.size());
+        std::vector<std::vector<int>> members(numClasses);
+        weight_.resize(numClasses);
+        for (int cls = 0; cls < numClasses; ++cls)
+        {
+            std::copy_n(classSizes_.begin() + static_cast<size_t>(order[cls]) * dim_, dim_,
+                sizes.begin() + static_cast<size_t>(cls) * dim_);
+            members[cls] = std::move(classItems_[order[cls]]);
+            weight_[cls] = weight[order[cls]];
+        }
+        classSizes_ = std::move(sizes);
+        classItems_ = std::move(members);
+        buckets_.clear();
+        count_.resize(numClasses);
+        for (int cls = 0; cls < numClasses; ++cls)
+        {
+            buckets_[key(&classSizes_[static_cast<size_t>(cls) * dim_], dim_)].push_back(cls);
+            count_[cls] = static_cast<int>(classItems_[cls].size());
+        }
+    }
+
+    int findClass(const int* size) const
+    {
+        auto it = buckets_.find(key(size, dim_));
+        if (it == buckets_.end())
+        {
+            return -1;
+        }
+        for (int cls : it->second)
+        {
+            if (std::equal(size, size + dim_, classSizes_.begin() + static_cast<size_t>(cls) * dim_))
+            {
+                return cls;
+            }
+        }
+        return -1;
+    }
+
+    void buildTriplets(const VectorItems& items)
+    {
+        int numClasses = static_cast<int>(classItems_.size());
+        triplets_.clear();
+        classTriplets_.assign(numClasses, {});
+        std::vector<int> residual(dim_);
+        std::vector<int> complement(dim_);
+        for (int p = 0; p < numClasses; ++p)
+        {
+            // p is the heaviest class of its triplets, so q lies between half the
+            // residual's weight and the lighter of p and the residual.
+            double residualWeight = 0.0;
+            for (int d = 0; d < dim_; ++d)
+            {
+                residual[d] = items.getCapacity(d) - classSizes_[static_cast<size_t>(p) * dim_ + d];
+                residualWeight += residual[d] / static_cast<double>(items.getCapacity(d));
+            }
+            int first = static_cast<int>(std::lower_bound(weight_.begin(), weight_.end(), residualWeight + 1e-9,
+                std::greater<double>()) - weight_.begin());
+            for (int q = std::max(p, first); q < numClasses && 2.0 * weight_[q] >= residualWeight - 1e-9; ++q)
+            {
+                bool inside = true;
+                for (int d = 0; d < dim_ && inside; ++d)
+                {
+                    complement[d] = residual[d] - classSizes_[static_cast<size_t>(q) * dim_ + d];
+                    inside = complement[d] >= 0;
+                }
+                int r = inside ? findClass(complement.data()) : -1;
+                if (r < q)
+                {
+                    continue;
+                }
+                int id = static_cast<int>(triplets_.size());
+                triplets_.push_back({ { p, q, r } });
+                if (!fits(id))
+                {
+                    triplets_.pop_back();
+                    continue;
+                }
+                forEachClass(id, [&](int cls) { classTriplets_[cls].push_back(id); });
+            }
+        }
+        available_.assign(triplets_.size(), 1);
+        options_.resize(numClasses);
+        for (int cls = 0; cls < numClasses; ++cls)
+        {
+            options_[cls] = static_cast<int>(classTriplets_[cls].size());
+        }
+    }
+
+    // Calls f once for every distinct class of the triplet.
+    template <typename F>
+    void forEachClass(int triplet, F f) const
+    {
+        const int* classes = triplets_[triplet].classes;
+        for (int k = 0; k < 3; ++k)
+        {
+            if (k == 0 || classes[k] != classes[k - 1])
+            {
+                f(classes[k]);
+            }
+        }
+    }
+
+    // Whether enough items are left to use the triplet once more.
+    bool fits(int triplet) const
+    {
+        const int* classes = triplets_[triplet].classes;
+        for (int k = 0; k < 3; ++k)
+        {
+            int needed = static_cast<int>(std::count(classes, classes + 3, classes[k]));
+            if (count_[classes[k]] < needed)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Takes (delta -1) or puts back (delta 1) the items of a triplet and updates which
+    // triplets of the classes involved are still available.
+    void apply(int triplet, int delta)
+    {
+        for (int cls : triplets_[triplet].classes)
+        {
+            count_[cls] += delta;
+        }
+        forEachClass(triplet, [&](int cls)
+        {
+            for (int other : classTriplets_[cls])
+            {
+                char now = fits(other) ? 1 : 0;
+                if (now != available_[other])
+                {
+                    available_[other] = now;
+                    forEachClass(other, [&](int changed) { options_[changed] += now ? 1 : -1; });
+                }
+            }
+        });
+    }
+
+    bool available(int triplet) const { return available_[triplet] != 0; }
+
+    // The class with items left and the fewest available triplets per item left, the
+    // heaviest on ties; -1 if one has none.
+    int chooseClass()
+    {
+        int best = -1;
+        for (int cls = 0; cls < static_cast<int>(count_.size()); ++cls)
+        {
+            if (count_[cls] == 0)
+            {
+                continue;
+            }
+            if (options_[cls] == 0)
+            {
+                return -1;
+            }
+            if (best == -1 || static_cast<long long>(options_[cls]) * count_[best]
+                < static_cast<long long>(options_[best]) * count_[cls])
+            {
+                best = cls;
+            }
+        }
+        return best;
+    }
+
+    int dim_ = 0;
+    std::unordered_map<uint64_t, std::vector<int>> buckets_;
+    std::vector<int> classSizes_;
+    std::vector<std::vector<int>> classItems_;
+    std::vector<int> count_;
+    std::vector<double> weight_;
+    std::vector<Triplet> triplets_;
+    std::vector<std::vector<int>> classTriplets_;
+    std::vector<char> available_;
+    std::vector<int> options_;
+    std::vector<Frame> frames_;
+    std::vector<int> assignment_;
+    bool exhausted_ = false;
+    std::mt19937 random_{ 1 };
+};
+
+void printBins(const VectorItems& items, const std::vector<int>& assignment, int numBins)
+{
+    std::vector<std::vector<int>> contents(numBins);
+    for (int i = 0; i < items.getNumItems(); ++i)
+    {
+        contents[assignment[i]].push_back(i);
+    }
+    for (int b = 0; b < numBins; ++b)
+    {
+        std::cout << "Bin " << b + 1 << ": ";
+        for (int i : contents[b])
+        {
+            std::cout << "Item " << items.ids[i] << " (Size:";
+            for (int d = 0; d < items.dim; ++d)
+            {
+                std::cout << " " << items.getSize(i, d);
+            }
+            std::cout << ") ";
+        }
+        std::cout << "\n";
+    }
+}
+
+template <int Dim>
+int solve(VectorItems& items, const std::string& algorithm, ItemOrder order, int batchIncrement, bool print)
+{
+    FitRule rule = FitRule::First;
+    if (algorithm.find("bfd") != std::string::npos)
+    {
+        rule = FitRule::Best;
+    }
+    else if (algorithm.find("wfd") != std::string::npos)
+    {
+        rule = FitRule::Worst;
+    }
+    else if (algorithm.find("dot") != std::string::npos)
+    {
+        rule = FitRule::DotProduct;
+    }
+    else if (algorithm.find("l2") != std::string::npos)
+    {
+        rule = FitRule::L2Norm;
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    items.sortDecreasing(order);
+    int numBins = 0;
+    std::vector<int> assignment;
+    bool triplets = false;
+    if (algorithm.rfind("triplet", 0) == 0 && TripletSolver::isTripletInstance(items))
+    {
+        TripletSolver solver;
+        if (solver.pack(items, 10LL * items.getNumItems()))
+        {
+            numBins = solver.getNumBins();
+            assignment = solver.getAssignment();
+            triplets = true;
+        }
+    }
+    if (triplets)
+    {
+        std::cout << "Perfect triplet packing found." << std::endl;
+    }
+    else if (algorithm.find("mb-") != std::string::npos)
+    {
+        VectorMultibin<Dim> multibin(items.getNumItems(), batchIncrement, rule);
+        if (!multibin.packItems(items))
+        {
+            std::cout << "Failed to find a solution with the maximum number of bins." << std::endl;
+            return 1;
+        }
+        numBins = multibin.getNumBins();
+        assignment = multibin.getAssignment();
+    }
+    else
+    {
+        VectorBinPacking<Dim> packing(items.capacities, rule);
+        packing.packItems(items);
+        numBins = packing.getNumBins();
+        assignment = packing.getAssignment();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+    if (print)
+    {
+        printBins(items, assignment, numBins);
+    }
+    std::cout << "Dimensions: " << items.dim << ", items: " << items.getNumItems() << ", lower bound: " << items.lowerBound() << std::endl;
+    std::cout << "Number of bins used: " << numBins << std::endl;
+    std::cout << "Execution time for " << algorithm << ": " << duration.count() << " microseconds" << std::endl;
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <file.vbp> [[mb-|triplet-]ffd|bfd|wfd|dot|l2] [batchIncrement]"
+                  << " [--order sum|product|max|l2] [--print]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(argv[1]);
+    VectorItems items;
+    if (!file || !readVbp(file, items))
+    {
+        std::cerr << "Cannot read instance " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::string algorithm = argc > 2 ? argv[2] : "ffd";
+    int batchIncrement = 1;
+    bool print = false;
+    ItemOrder order = ItemOrder::Sum;
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--print")
+        {
+            print = true;
+        }
+        else if (arg == "--order" && i + 1 < argc)
+        {
+            std::string key = argv[++i];
+            if (key == "sum")
+            {
+                order = ItemOrder::Sum;
+            }
+            else if (key == "product")
+            {
+                order = ItemOrder::Product;
+            }
+            else if (key == "max")
+            {
+                order = ItemOrder::Max;
+            }
+            else if (key == "l2")
+            {
+                order = ItemOrder::L2;
+            }
+            else
+            {
+                std::cerr << "Unknown item order: " << key << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            batchIncrement = std::max(1, std::stoi(arg));
+        }
+    }
+
+    // Dispatch on the dimension count from the .vbp header.
+    switch (items.dim)
+    {
+    case 1: return solve<1>(items, algorithm, order, batchIncrement, print);
+    case 2: return solve<2>(items, algorithm, order, batchIncrement, print);
+    case 3: return solve<3>(items, algorithm, order, batchIncrement, print);
+    case 4: return solve<4>(items, algorithm, order, batchIncrement, print);
+    default: return solve<0>(items, algorithm, order, batchIncrement, print);
+    }
+}
@@ -0,0 +1,788 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+// ---------------VM placement (core, memory)-------------------
+//
+// Reads the tab-separated table written by data/Falkenauer_CSP/redo.py
+//   app_id  nb_instances  core  memory  inter_degree  inter_aff
+// or the raw CSP .txt file redo.py starts from (item count, capacity, then
+// "core<TAB>nb_instances" per line), so placement does not need the Python step.
+
+class Application
+{
+public:
+    Application(int appId, int nbInstances, int core, int memory, int interDegree)
+        : appId_(appId), nbInstances_(nbInstances), core_(core), memory_(memory), interDegree_(interDegree) {}
+    int getAppId() const { return appId_; }
+    int getNbInstances() const { return nbInstances_; }
+    int getCore() const { return core_; }
+    int getMemory() const { return memory_; }
+    int getInterDegree() const { return interDegree_; }
+
+private:
+    int appId_;
+    int nbInstances_;
+    int core_;
+    int memory_;
+    int interDegree_;
+};
+
+// All applications of one file. The inter_aff lists are kept in one flat array:
+// the affinity list of application a is affinityIds[affinityOffsets[a] .. affinityOffsets[a + 1]).
+class PlacementInstance
+{
+public:
+    std::vector<Application> applications;
+    std::vector<int> affinityOffsets{ 0 };
+    std::vector<int> affinityIds;
+    int coreCapacity = 0;
+
+    const int* affinityBegin(int app) const { return affinityIds.data() + affinityOffsets[app]; }
+    const int* affinityEnd(int app) const { return affinityIds.data() + affinityOffsets[app + 1]; }
+
+    long long getNumItems() const
+    {
+        long long total = 0;
+        for (const auto& app : applications)
+        {
+            total += app.getNbInstances();
+        }
+        return total;
+    }
+};
+
+// Streaming line reader: the file is consumed in fixed-size chunks and every
+// complete line is handed to the callback without building intermediate strings.
+class LineReader
+{
+public:
+    LineReader(std::istream& in, size_t chunkSize = 1 << 16) : in_(in), buffer_(chunkSize) {}
+
+    template <typename Callback>
+    bool forEachLine(Callback callback)
+    {
+        size_t kept = 0;
+        while (true)
+        {
+            if (kept == buffer_.size())
+            {
+                buffer_.resize(buffer_.size() * 2);
+            }
+            in_.read(buffer_.data() + kept, buffer_.size() - kept);
+            size_t filled = kept + static_cast<size_t>(in_.gcount());
+            bool eof = filled == kept;
+
+            const char* begin = buffer_.data();
+            const char* end = buffer_.data() + filled;
+            const char* lineStart = begin;
+            for (const char* pos = begin; pos < end; ++pos)
+            {
+                if (*pos == '\n')
+                {
+                    if (!callback(lineStart, trimEnd(lineStart, pos)))
+                    {
+                        return false;
+                    }
+                    lineStart = pos + 1;
+                }
+            }
+
+            kept = end - lineStart;
+            if (eof)
+            {
+                return kept == 0 || callback(lineStart, trimEnd(lineStart, end));
+            }
+            std::copy(lineStart, end, buffer_.data());
+        }
+    }
+
+private:
+    static const char* trimEnd(const char* begin, const char* end)
+    {
+        while (end > begin && (end[-1] == '\r' || end[-1] == ' '))
+        {
+            --end;
+        }
+        return end;
+    }
+
+    std::istream& in_;
+    std::vector<char> buffer_;
+};
+
+// Parses one integer field and skips the separators that follow it.
+static bool parseField(const char*& pos, const char* end, int& value)
+{
+    while (pos < end && (*pos == ' ' || *pos == '\t'))
+    {
+        ++pos;
+    }
+    auto result = std::from_chars(pos, end, value);
+    if (result.ec != std::errc())
+    {
+        return false;
+    }
+    pos = result.ptr;
+    return true;
+}
+
+// Parses a Python list literal such as "[]" or "[3, 17]".
+static bool parseAffinityList(const char* pos, const char* end, std::vector<int>& ids)
+{
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '"'))
+    {
+        ++pos;
+    }
+    if (pos == end)
+    {
+        return true;
+    }
+    if (*pos != '[')
+    {
+        return false;
+    }
+    ++pos;
+    while (pos < end && *pos != ']')
+    {
+        if (*pos == ',' || *pos == ' ')
+        {
+            ++pos;
+            continue;
+        }
+        int id = 0;
+        auto result = std::from_chars(pos, end, id);
+        if (result.ec != std::errc())
+        {
+            return false;
+        }
+        ids.push_back(id);
+        pos = result.ptr;
+    }
+    return pos < end;
+}
+
+bool readPlacementCsv(std::istream& in, PlacementInstance& instance)
+{
+    LineReader reader(in);
+    bool header = true;
+    long long lineNumber = 0;
+    return reader.forEachLine([&](const char* pos, const char* end) {
+        ++lineNumber;
+        if (pos == end)
+        {
+            return true;
+        }
+        if (header)
+        {
+            header = false;
+            if (*pos < '0' || *pos > '9')
+            {
+                return true;
+            }
+        }
+
+        int appId, nbInstances, core, memory, interDegree;
+        if (!parseField(pos, end, appId) || !parseField(pos, end, nbInstances) || !parseField(pos, end, core)
+            || !parseField(pos, end, memory) || !parseField(pos, end, interDegree)
+            || !parseAffinityList(pos, end, instance.affinityIds))
+        {
+            std::cerr << "Malformed placement row at line " << lineNumber << std::endl;
+            return false;
+        }
+        instance.applications.emplace_back(appId, nbInstances, core, memory, interDegree);
+        instance.affinityOffsets.push_back(static_cast<int>(instance.affinityIds.size()));
+        return true;
+    });
+}
+
+// Reads the raw CSP file the same way redo.py does: memory 1, no affinities.
+bool readPlacementCsp(std::istream& in, PlacementInstance& instance)
+{
+    LineReader reader(in);
+    long long lineNumber = 0;
+    return reader.forEachLine([&](const char* pos, const char* end) {
+        ++lineNumber;
+        if (pos == end)
+        {
+            return true;
+        }
+        int core = 0;
+        if (lineNumber == 1)
+        {
+            return parseField(pos, end, core);
+        }
+        if (lineNumber == 2)
+        {
+            return parseField(pos, end, instance.coreCapacity);
+        }
+
+        int nbInstances = 1;
+        if (!parseField(pos, end, core) || (pos < end && !parseField(pos, end, nbInstances)))
+        {
+            std::cerr << "Malformed CSP row at line " << lineNumber << std::endl;
+            return false;
+        }
+        int appId = static_cast<int>(instance.applications.size()) + 1;
+        instance.applications.emplace_back(appId, nbInstances, core, 1, 0);
+        instance.affinityOffsets.push_back(static_cast<int>(instance.affinityIds.size()));
+        return true;
+    });
+}
+
+class Server
+{
+public:
+    Server(int coreCapacity, int memoryCapacity) : remainingCore_(coreCapacity), remainingMemory_(memoryCapacity) {}
+    bool canFit(const Application& app) const
+    {
+        return remainingCore_ >= app.getCore() && remainingMemory_ >= app.getMemory();
+    }
+    void addInstance(const Application& app)
+    {
+        remainingCore_ -= app.getCore();
+        remainingMemory_ -= app.getMemory();
+    }
+
+private:
+    int remainingCore_;
+    int remainingMemory_;
+};
+
+// First fit decreasing by core over every instance of every application.
+// assignment[k] is the server of the k-th instance in application order.
+int placeFFD(const PlacementInstance& instance, int coreCapacity, int memoryCapacity, std::vector<int>& assignment)
+{
+    std::vector<int> order(instance.applications.size());
+    for (int i = 0; i < static_cast<int>(order.size()); ++i)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return instance.applications[a].getCore() > instance.applications[b].getCore();
+        });
+
+    std::vector<long long> firstInstance(instance.applications.size() + 1, 0);
+    for (size_t a = 0; a < instance.applications.size(); ++a)
+    {
+        firstInstance[a + 1] = firstInstance[a] + instance.applications[a].getNbInstances();
+    }
+    assignment.assign(firstInstance.back(), -1);
+
+    std::vector<Server> servers;
+    for (int a : order)
+    {
+        const Application& app = instance.applications[a];
+        if (!Server(coreCapacity, memoryCapacity).canFit(app))
+        {
+            return -1;
+        }
+        // Instances of one application are placed in order, so the search restarts
+        // where the previous instance went.
+        int start = 0;
+        for (int k = 0; k < app.getNbInstances(); ++k)
+        {
+            int chosen = -1;
+            for (int s = start; s < static_cast<int>(servers.size()); ++s)
+            {
+                if (servers[s].canFit(app))
+                {
+                    chosen = s;
+                    break;
+                }
+            }
+            if (chosen == -1)
+            {
+                servers.emplace_back(coreCapacity, memoryCapacity);
+                chosen = static_cast<int>(servers.size()) - 1;
+            }
+            servers[chosen].addInstance(app);
+            assignment[firstInstance[a] + k] = chosen;
+            start = chosen;
+        }
+    }
+    return static_cast<int>(servers.size());
+}
+
+// Co-location constraints between applications.
+//   anti-affinity(a, b): no server may host an instance of a and one of b
+//                        (a == b spreads the instances of a over distinct servers),
+//   affinity(a, b):      instances are placed in bundles, the k-th instance of every
+//                        application of an affinity group goes to the same server.
+// Conflicts are kept as one bitset over application indices per application.
+class PlacementConstraints
+{
+public:
+    PlacementConstraints(int numApps)
+        : numApps_(numApps), numWords_((numApps + 63) / 64), conflicts_(static_cast<size_t>(numApps) * numWords_, 0),
+          group_(numApps)
+    {
+        for (int a = 0; a < numApps; ++a)
+        {
+            group_[a] = a;
+        }
+    }
+
+    // inter_aff lists are taken as anti-affinity with the listed app_ids.
+    static PlacementConstraints fromInstance(const PlacementInstance& instance)
+    {
+        int numApps = static_cast<int>(instance.applications.size());
+        PlacementConstraints constraints(numApps);
+        std::unordered_map<int, int> indexOf;
+        for (int a = 0; a < numApps; ++a)
+        {
+            indexOf[instance.applications[a].getAppId()] = a;
+        }
+        for (int a = 0; a < numApps; ++a)
+        {
+            for (const int* id = instance.affinityBegin(a); id != instance.affinityEnd(a); ++id)
+            {
+                auto it = indexOf.find(*id);
+                if (it != indexOf.end())
+                {
+                    constraints.addAntiAffinity(a, it->second);
+                }
+            }
+        }
+        return constraints;
+    }
+
+    void addAntiAffinity(int a, int b)
+    {
+        mutableConflictRow(a)[b / 64] |= uint64_t(1) << (b % 64);
+        mutableConflictRow(b)[a / 64] |= uint64_t(1) << (a % 64);
+        hasConstraints_ = true;
+    }
+
+    void addAffinity(int a, int b)
+    {
+        group_[findGroup(a)] = findGroup(b);
+        hasConstraints_ = true;
+    }
+
+    bool hasConstraints() const { return hasConstraints_; }
+    int getNumWords() const { return numWords_; }
+    int findGroup(int a)
+    {
+        while (group_[a] != a)
+        {
+            group_[a] = group_[group_[a]];
+            a = group_[a];
+        }
+        return a;
+    }
+    int findGroup(int a) const
+    {
+        while (group_[a] != a)
+        {
+            a = group_[a];
+        }
+        return a;
+    }
+    const uint64_t* conflictRow(int a) const { return conflicts_.data() + static_cast<size_t>(a) * numWords_; }
+
+private:
+    uint64_t* mutableConflictRow(int a) { return conflicts_.data() + static_cast<size_t>(a) * numWords_; }
+
+    int numApps_;
+    int numWords_;
+    std::vector<uint64_t> conflicts_;
+    std::vector<int> group_;
+    bool hasConstraints_ = false;
+};
+
+// Bundles k in [firstBundle, lastBundle) of an affinity group all have the same
+// members: the first memberCount applications of the group. Each bundle holds one
+// instance of every member and goes to a single server.
+class BundleShape
+{
+public:
+    int group = 0;
+    int memberCount = 0;
+    int firstBundle = 0;
+    int lastBundle = 0;
+    int core = 0;
+    int memory = 0;
+    // Ranges in the shared arrays of non-zero words of the members' conflict rows
+    // (OR-ed together) and of the member set itself.
+    int conflictBegin = 0;
+    int conflictEnd = 0;
+    int classBegin = 0;
+    int classEnd = 0;
+};
+
+static void appendSparseWords(const std::vector<uint64_t>& words, std::vector<std::pair<int, uint64_t>>& sparse)
+{
+    for (int w = 0; w < static_cast<int>(words.size()); ++w)
+    {
+        if (words[w] != 0)
+        {
+            sparse.emplace_back(w, words[w]);
+        }
+    }
+}
+
+// FFD by core over bundles, honouring the constraints. Every server keeps a bitset of
+// the application classes it hosts, so a conflict check is a word-wise AND over the
+// few non-zero words of the bundle's conflict mask instead of a scan of its contents.
+// Returns the number of servers, -1 when a bundle does not fit on an empty server and
+// -2 when an affinity group contains a conflicting pair.
+int placeConstrainedFFD(const PlacementInstance& instance, PlacementConstraints& constraints,
+    int coreCapacity, int memoryCapacity, std::vector<int>& assignment)
+{
+    int numApps = static_cast<int>(instance.applications.size());
+    int numWords = constraints.getNumWords();
+
+    std::vector<long long> firstInstance(numApps + 1, 0);
+    for (int a = 0; a < numApps; ++a)
+    {
+        firstInstance[a + 1] = firstInstance[a] + instance.applications[a].getNbInstances();
+    }
+    assignment.assign(firstInstance.back(), -1);
+
+    // Members of every affinity group by decreasing number of instances, so the
+    // members of bundle k are a prefix of the group.
+    std::vector<std::vector<int>> members(numApps);
+    for (int a = 0; a < numApps; ++a)
+    {
+        members[constraints.findGroup(a)].push_back(a);
+    }
+
+    std::vector<BundleShape> shapes;
+    std::vector<std::pair<int, uint64_t>> conflictWords;
+    std::vector<std::pair<int, uint64_t>> classWords;
+    std::vector<uint64_t> conflictMask(numWords);
+    std::vector<uint64_t> classMask(numWords);
+    for (int g = 0; g < numApps; ++g)
+    {
+        auto& group = members[g];
+        if (group.empty())
+        {
+            continue;
+        }
+        std::stable_sort(group.begin(), group.end(), [&](int a, int b) {
+            return instance.applications[a].getNbInstances() > instance.applications[b].getNbInstances();
+            });
+        for (int count = static_cast<int>(group.size()); count > 0; --count)
+        {
+            BundleShape shape;
+            shape.group = g;
+            shape.memberCount = count;
+            shape.firstBundle = count < static_cast<int>(group.size()) ? instance.applications[group[count]].getNbInstances() : 0;
+            shape.lastBundle = instance.applications[group[count - 1]].getNbInstances();
+            if (shape.firstBundle >= shape.lastBundle)
+            {
+                continue;
+            }
+            std::fill(conflictMask.begin(), conflictMask.end(), 0);
+            std::fill(classMask.begin(), classMask.end(), 0);
+            for (int m = 0; m < count; ++m)
+            {
+                int a = group[m];
+                shape.core += instance.applications[a].getCore();
+                shape.memory += instance.applications[a].getMemory();
+                classMask[a / 64] |= uint64_t(1) << (a % 64);
+                const uint64_t* row = constraints.conflictRow(a);
+                for (int w = 0; w < numWords; ++w)
+                {
+                    conflictMask[w] |= row[w];
+                }
+            }
+            // A bundle holds one instance per member, so only conflicts between two
+            // different members make the group infeasible; a member's own bit only
+            // spreads its bundles.
+            for (int m = 0; m < count; ++m)
+            {
+                int a = group[m];
+                const uint64_t* row = constraints.conflictRow(a);
+                for (int w = 0; w < numWords; ++w)
+                {
+                    uint64_t others = w == a / 64 ? classMask[w] & ~(uint64_t(1) << (a % 64)) : classMask[w];
+                    if ((row[w] & others) != 0)
+                    {
+                        return -2;
+                    }
+                }
+            }
+            if (shape.core > coreCapacity || shape.memory > memoryCapacity)
+            {
+                return -1;
+            }
+            shape.conflictBegin = static_cast<int>(conflictWords.size());
+            appendSparseWords(conflictMask, conflictWords);
+            shape.conflictEnd = static_cast<int>(conflictWords.size());
+            shape.classBegin = static_cast<int>(classWords.size());
+            appendSparseWords(classMask, classWords);
+            shape.classEnd = static_cast<int>(classWords.size());
+            shapes.push_back(shape);
+        }
+    }
+
+    std::stable_sort(shapes.begin(), shapes.end(), [](const BundleShape& a, const BundleShape& b) {
+        return a.core > b.core;
+        });
+
+    std::vector<int> remainingCore;
+    std::vector<int> remainingMemory;
+    std::vector<uint64_t> hosted;
+    for (const BundleShape& shape : shapes)
+    {
+        const auto& group = members[shape.group];
+        // Bundles of one shape are identical, so the next one cannot go to a server
+        // the previous one skipped: loads and hosted classes only grow.
+        int start = 0;
+        for (int k = shape.firstBundle; k < shape.lastBundle; ++k)
+        {
+            int chosen = -1;
+            for (int s = start; s < static_cast<int>(remainingCore.size()); ++s)
+            {
+                if (remainingCore[s] < shape.core || remainingMemory[s] < shape.memory)
+                {
+                    continue;
+                }
+                const uint64_t* classes = hosted.data() + static_cast<size_t>(s) * numWords;
+                bool conflict = false;
+                for (int w = shape.conflictBegin; w < shape.conflictEnd; ++w)
+                {
+                    if ((classes[conflictWords[w].first] & conflictWords[w].second) != 0)
+                    {
+                        conflict = true;
+                        break;
+                    }
+                }
+                if (!conflict)
+                {
+                    chosen = s;
+                    break;
+                }
+            }
+            if (chosen == -1)
+            {
+                chosen = static_cast<int>(remainingCore.size());
+                remainingCore.push_back(coreCapacity);
+                remainingMemory.push_back(memoryCapacity);
+                hosted.resize(hosted.size() + numWords, 0);
+            }
+
+            remainingCore[chosen] -= shape.core;
+            remainingMemory[chosen] -= shape.memory;
+            uint64_t* classes = hosted.data() + static_cast<size_t>(chosen) * numWords;
+            for (int w = shape.classBegin; w < shape.classEnd; ++w)
+            {
+                classes[classWords[w].first] |= classWords[w].second;
+            }
+            for (int m = 0; m < shape.memberCount; ++m)
+            {
+                assignment[firstInstance[group[m]] + k] = chosen;
+            }
+            start = chosen;
+        }
+    }
+    return static_cast<int>(remainingCore.size());
+}
+
+// Counts the server/anti-affinity pairs violated by an assignment, plus every instance
+// that is not on the server of the same bundle of its affinity group.
+long long countViolations(const PlacementInstance& instance, const PlacementConstraints& constraints,
+    const std::vector<int>& assignment, int numServers)
+{
+    int numApps = static_cast<int>(instance.applications.size());
+    int numWords = constraints.getNumWords();
+    std::vector<uint64_t> hosted(static_cast<size_t>(numServers) * numWords, 0);
+    std::vector<int> instancesOnServer;
+    long long violations = 0;
+    long long index = 0;
+    for (int a = 0; a < numApps; ++a)
+    {
+        const uint64_t* row = constraints.conflictRow(a);
+        bool selfConflict = (row[a / 64] >> (a % 64)) & 1;
+        for (int k = 0; k < instance.applications[a].getNbInstances(); ++k, ++index)
+        {
+            uint64_t* classes = hosted.data() + static_cast<size_t>(assignment[index]) * numWords;
+            bool alreadyHosted = (classes[a / 64] >> (a % 64)) & 1;
+            if (alreadyHosted && selfConflict)
+            {
+                ++violations;
+            }
+            classes[a / 64] |= uint64_t(1) << (a % 64);
+        }
+    }
+    // Server of bundle k of every group: that of the first instance k seen in the group.
+    std::vector<std::vector<int>> bundleServer(numApps);
+    index = 0;
+    for (int a = 0; a < numApps; ++a)
+    {
+        std::vector<int>& servers = bundleServer[constraints.findGroup(a)];
+        for (int k = 0; k < instance.applications[a].getNbInstances(); ++k, ++index)
+        {
+            if (k == static_cast<int>(servers.size()))
+            {
+                servers.push_back(assignment[index]);
+            }
+            else if (servers[k] != assignment[index])
+            {
+                ++violations;
+            }
+        }
+    }
+    for (int s = 0; s < numServers; ++s)
+    {
+        const uint64_t* classes = hosted.data() + static_cast<size_t>(s) * numWords;
+        for (int a = 0; a < numApps; ++a)
+        {
+            if (((classes[a / 64] >> (a % 64)) & 1) == 0)
+            {
+                continue;
+            }
+            const uint64_t* row = constraints.conflictRow(a);
+            for (int b = a + 1; b < numApps; ++b)
+            {
+                if (((row[b / 64] >> (b % 64)) & 1) && ((classes[b / 64] >> (b % 64)) & 1))
+                {
+                    ++violations;
+                }
+            }
+        }
+    }
+    return violations;
+}
+
+static bool endsWith(const std::string& text, const std::string& suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Parses "a:b" into two app_ids.
+static bool parsePair(const std::string& text, int& a, int& b)
+{
+    size_t colon = text.find(':');
+    if (colon == std::string::npos)
+    {
+        return false;
+    }
+    a = std::stoi(text.substr(0, colon));
+    b = std::stoi(text.substr(colon + 1));
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <file.csv|file.txt> [coreCapacity] [memoryCapacity]"
+                  << " [--unconstrained] [--affinity a:b] [--anti-affinity a:b]" << std::endl;
+        return 1;
+    }
+
+    std::string path = argv[1];
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Cannot open " << path << std::endl;
+        return 1;
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    PlacementInstance instance;
+    bool ok = endsWith(path, ".txt") ? readPlacementCsp(file, instance) : readPlacementCsv(file, instance);
+    if (!ok)
+    {
+        return 1;
+    }
+
+    int coreCapacity = instance.coreCapacity > 0 ? instance.coreCapacity : 1000;
+    int memoryCapacity = -1;
+    bool unconstrained = false;
+    std::vector<std::pair<int, int>> affinityPairs;
+    std::vector<std::pair<int, int>> antiAffinityPairs;
+    int positional = 0;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        int a = 0, b = 0;
+        if (arg == "--unconstrained")
+        {
+            unconstrained = true;
+        }
+        else if ((arg == "--affinity" || arg == "--anti-affinity") && i + 1 < argc && parsePair(argv[i + 1], a, b))
+        {
+            (arg == "--affinity" ? affinityPairs : antiAffinityPairs).emplace_back(a, b);
+            ++i;
+        }
+        else if (positional == 0)
+        {
+            coreCapacity = std::stoi(arg);
+            ++positional;
+        }
+        else
+        {
+            memoryCapacity = std::stoi(arg);
+            ++positional;
+        }
+    }
+    if (memoryCapacity < 0)
+    {
+        memoryCapacity = coreCapacity;
+    }
+
+    PlacementConstraints constraints = PlacementConstraints::fromInstance(instance);
+    std::unordered_map<int, int> indexOf;
+    for (int a = 0; a < static_cast<int>(instance.applications.size()); ++a)
+    {
+        indexOf[instance.applications[a].getAppId()] = a;
+    }
+    for (const auto& pair : affinityPairs)
+    {
+        if (indexOf.count(pair.first) && indexOf.count(pair.second))
+        {
+            constraints.addAffinity(indexOf[pair.first], indexOf[pair.second]);
+        }
+    }
+    for (const auto& pair : antiAffinityPairs)
+    {
+        if (indexOf.count(pair.first) && indexOf.count(pair.second))
+        {
+            constraints.addAntiAffinity(indexOf[pair.first], indexOf[pair.second]);
+        }
+    }
+    bool constrained = !unconstrained && constraints.hasConstraints();
+
+    auto read_time = std::chrono::high_resolution_clock::now();
+
+    std::vector<int> assignment;
+    int servers = constrained ? placeConstrainedFFD(instance, constraints, coreCapacity, memoryCapacity, assignment)
+                              : placeFFD(instance, coreCapacity, memoryCapacity, assignment);
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto read_duration = std::chrono::duration_cast<std::chrono::microseconds>(read_time - start_time);
+    auto solve_duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - read_time);
+
+    std::cout << "Applications: " << instance.applications.size() << ", instances: " << instance.getNumItems() << std::endl;
+    if (servers == -1)
+    {
+        std::cout << "An application does not fit on an empty server." << std::endl;
+        return 1;
+    }
+    if (servers == -2)
+    {
+        std::cout << "An affinity group contains applications with anti-affinity." << std::endl;
+        return 1;
+    }
+    std::cout << "Number of servers used: " << servers << std::endl;
+    if (constrained)
+    {
+        std::cout << "Constraint violations: " << countViolations(instance, constraints, assignment, servers) << std::endl;
+    }
+    std::cout << "Read time: " << read_duration.count() << " microseconds" << std::endl;
+    std::cout << "Execution time for " << (constrained ? "constrained FFD" : "FFD") << ": "
+              << solve_duration.count() << " microseconds" << std::endl;
+
+    return 0;
+}